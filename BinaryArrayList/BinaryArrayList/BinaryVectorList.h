@@ -15,837 +15,3601 @@ OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version>
+#endif
+#endif
+#if defined(__cpp_lib_bitops)
+#include <bit>
+#endif
+#if defined(__cpp_lib_ranges)
+#include <ranges>
+#endif
+
 /**
-* \brief A v-list implementation the array abstract data structure.
-* It's API is a combination of those of std::vector and std::list with a few exceptions.
-* Anything asymptotically slower than linear with respect to container size from the std::list API is not provided.
-* This is a way from keeping users from doing stupid (slow) things, and blaming the data structure.
-* std::vector.data() is not provided because it wholly is dependent on the underlying implementation of std::vector.
-* The goal here is to use an implementation free interface to develop a new implementation for the array abstract data structure, 
-* that is the implementation details can vary from each individual implementor, but the API/interface remain the same. 
-* data() doesn't fit that goal, it assumes that std::vector is implemented as 1 continuous block of memory,
-* which this implementation will intentionally break.
-* BinaryVectorList can be used exactly like std::vector (except for std::vector.data()) 
-* including having constant time Random Access Iterators, leveraging some spacial locality of elements, 
-* but it should be asymptotically faster on inserts at the end than std::vector.
-* The downside is that it uses less spacial locality than std::vector
-* by using several different sized blocks of continuous memory instead of just 1.
-* \tparam allocator_type The type of allocator to use in the BinaryVectorList container.
-* \tparam value_type The type of elements in the BinaryVectorList container.
+* BVL_CONSTEXPR20 marks what can run in constant expressions with C++20 constexpr allocation,
+* so that a BinaryVectorList can be filled at compile time. It expands to nothing before C++20.
 */
-template<typename value_type, typename allocator_type = std::allocator<value_type> >
-class BinaryVectorList
+#if defined(__cpp_constexpr_dynamic_alloc) && defined(__cpp_lib_constexpr_dynamic_alloc) && defined(__cpp_lib_is_constant_evaluated) && defined(__cpp_lib_bitops)
+#define BVL_HAS_CONSTEXPR20 1
+#define BVL_CONSTEXPR20 constexpr
+#else
+#define BVL_CONSTEXPR20
+#endif
+
+/**
+* Define BVL_HARDENED to 1 to check element access, iterator use and iterator comparisons at run time,
+* and abort with a message on the first misuse. Iterators then carry the list's generation,
+* which erase, insert, clear and swap advance, so using an iterator they invalidated is caught.
+* Appending never moves an element (except below a contiguous limit, see set_contiguous_limit), so push_back and emplace_back leave iterators valid.
+* With BVL_HARDENED undefined or 0 the checks are not compiled at all and iterators do not carry the generation.
+*/
+#if !defined(BVL_HARDENED)
+#define BVL_HARDENED 0
+#endif
+#if BVL_HARDENED
+#include <cstdio>
+#include <cstdlib>
+#define BVL_HARDENED_CHECK(condition, message) ((condition) ? (void)0 : bvl::detail::hardened_failure(message))
+#else
+#define BVL_HARDENED_CHECK(condition, message) ((void)0)
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__))
+#include <immintrin.h>
+#define BVL_HAS_BMI2 1
+#endif
+#if defined(__AVX512F__) && defined(__AVX512CD__)
+#include <immintrin.h>
+#define BVL_HAS_AVX512CD 1
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define BVL_HAS_AVX2 1
+#endif
+
+namespace bvl
 {
-public:
-	//Typedefs
+	namespace detail
+	{
+		/**
+		* \brief Index of the highest set bit
+		* \param[in] x Value to scan. Must not be 0.
+		* \return floor(log2(x))
+		*/
+		BVL_CONSTEXPR20 inline unsigned floor_log2(std::uint64_t x) noexcept
+		{
+#if defined(BVL_HAS_CONSTEXPR20)
+			return 63u - static_cast<unsigned>(std::countl_zero(x));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+			unsigned long uIndex = 0;
+			_BitScanReverse64(&uIndex, x);
+			return static_cast<unsigned>(uIndex);
+#elif defined(_MSC_VER)
+			unsigned long uIndex = 0;
+			if (x >> 32)
+			{
+				_BitScanReverse(&uIndex, static_cast<unsigned long>(x >> 32));
+				return static_cast<unsigned>(uIndex) + 32;
+			}
+			_BitScanReverse(&uIndex, static_cast<unsigned long>(x));
+			return static_cast<unsigned>(uIndex);
+#else
+			return 63u - static_cast<unsigned>(__builtin_clzll(x));
+#endif
+		}
+
+		/**
+		* \brief Index of the lowest set bit
+		* \param[in] x Value to scan. Must not be 0.
+		* \return The number of trailing zero bits in x
+		*/
+		inline unsigned count_trailing_zeros(std::uint64_t x) noexcept
+		{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+			unsigned long uIndex = 0;
+			_BitScanForward64(&uIndex, x);
+			return static_cast<unsigned>(uIndex);
+#elif defined(_MSC_VER)
+			unsigned long uIndex = 0;
+			if (static_cast<unsigned long>(x))
+			{
+				_BitScanForward(&uIndex, static_cast<unsigned long>(x));
+				return static_cast<unsigned>(uIndex);
+			}
+			_BitScanForward(&uIndex, static_cast<unsigned long>(x >> 32));
+			return static_cast<unsigned>(uIndex) + 32;
+#else
+			return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+		}
+
+		/**
+		* \brief Number of set bits, using the hardware popcnt instruction where the compiler exposes it
+		* \param[in] x Value to count.
+		* \return The number of set bits in x
+		*/
+		inline unsigned popcount64(std::uint64_t x) noexcept
+		{
+#if defined(_MSC_VER) && defined(_M_X64)
+			return static_cast<unsigned>(__popcnt64(x));
+#elif defined(_MSC_VER) && defined(_M_IX86)
+			return static_cast<unsigned>(__popcnt(static_cast<unsigned int>(x)) + __popcnt(static_cast<unsigned int>(x >> 32)));
+#elif defined(_MSC_VER)
+			x = x - ((x >> 1) & 0x5555555555555555ull);
+			x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+			x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+			return static_cast<unsigned>((x * 0x0101010101010101ull) >> 56);
+#else
+			return static_cast<unsigned>(__builtin_popcountll(x));
+#endif
+		}
+
+		/**
+		* \brief Position of the k-th set bit (0 based) of a word
+		* \param[in] x Word to search. Must have more than k bits set.
+		* \param[in] k Rank of the bit to find.
+		* \return The bit index of the k-th set bit
+		*/
+		inline unsigned select64(std::uint64_t x, unsigned k) noexcept
+		{
+#if defined(BVL_HAS_BMI2) && (defined(__x86_64__) || defined(_M_X64))
+			return count_trailing_zeros(_pdep_u64(std::uint64_t(1) << k, x));
+#else
+			for (; k; --k)
+			{
+				x &= x - 1;
+			}
+			return count_trailing_zeros(x);
+#endif
+		}
+
+#if BVL_HARDENED
+		/**
+		* \brief Reports a failed hardened mode check and aborts
+		*/
+		[[noreturn]] inline void hardened_failure(const char* pMessage) noexcept
+		{
+			std::fprintf(stderr, "BinaryVectorList: %s\n", pMessage);
+			std::abort();
+		}
+#endif
+
+		/**
+		* \brief Whether the call is being evaluated at compile time, always false before C++20
+		*/
+		BVL_CONSTEXPR20 inline bool is_constant_evaluated() noexcept
+		{
+#if defined(BVL_HAS_CONSTEXPR20)
+			return std::is_constant_evaluated();
+#else
+			return false;
+#endif
+		}
+
+		/**
+		* \brief Hints the cache line holding p into every level of the cache. p does not have to be valid.
+		*/
+		BVL_CONSTEXPR20 inline void prefetch(const void* p) noexcept
+		{
+#if defined(BVL_HAS_CONSTEXPR20)
+			if (std::is_constant_evaluated())
+			{
+				return;
+			}
+#endif
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+			_mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#elif defined(__GNUC__) || defined(__clang__)
+			__builtin_prefetch(p);
+#else
+			(void)p;
+#endif
+		}
+
+		/**
+		* \brief The doubling block layout shared by every BinaryVectorList.
+		* Block k holds (1 << FirstBlockLog2) << k elements and starts at position ((1 << FirstBlockLog2) << k) - (1 << FirstBlockLog2).
+		* Adding the first block size to a position turns its highest set bit into the block number,
+		* and the remaining bits into the offset within that block.
+		* \tparam FirstBlockLog2 log2 of the number of elements in block 0.
+		*/
+		template<unsigned FirstBlockLog2>
+		struct BlockLayout
+		{
+			/**
+			* log2 of the size of block 0
+			*/
+			static const unsigned first_block_log2 = FirstBlockLog2;
+
+			/**
+			* The number of elements in block 0
+			*/
+			static const std::uint64_t first_block_size = std::uint64_t(1) << FirstBlockLog2;
+
+			/**
+			* The number of blocks needed to address every position representable in 64 bits
+			*/
+			static const unsigned max_blocks = 64 - FirstBlockLog2;
+
+			/**
+			* \brief Number of elements in block k
+			*/
+			static BVL_CONSTEXPR20 std::uint64_t block_size(unsigned k) noexcept
+			{
+				return first_block_size << k;
+			}
+
+			/**
+			* \brief Position of the first element of block k. This is also the total size of blocks [0, k)
+			*/
+			static BVL_CONSTEXPR20 std::uint64_t block_start(unsigned k) noexcept
+			{
+				return (first_block_size << k) - first_block_size;
+			}
+
+			/**
+			* \brief Block that holds position p
+			*/
+			static BVL_CONSTEXPR20 unsigned block_of(std::uint64_t p) noexcept
+			{
+				return floor_log2(p + first_block_size) - FirstBlockLog2;
+			}
+
+			/**
+			* \brief Offset of position p within block k, where k == block_of(p)
+			*/
+			static BVL_CONSTEXPR20 std::uint64_t offset_of(std::uint64_t p, unsigned k) noexcept
+			{
+				return (p + first_block_size) - (first_block_size << k);
+			}
+
+			/**
+			* \brief Whether position p is the first element of its block
+			*/
+			static BVL_CONSTEXPR20 bool is_block_start(std::uint64_t p) noexcept
+			{
+				std::uint64_t q = p + first_block_size;
+				return (q & (q - 1)) == 0;
+			}
+
+			/**
+			* \brief Block and offset of many positions at once
+			* With AVX-512 8 positions are translated per step using a 64 bit lzcnt.
+			* With AVX2, which has no 64 bit lzcnt, 4 positions per step are turned into doubles by
+			* or-ing them into the mantissa of 2^52, and floor(log2) is read from the exponent. That is only exact below 2^52,
+			* so a step with a larger position falls back to the scalar code.
+			* \param[in] pPositions	Positions to translate.
+			* \param[in] uCount		Number of positions.
+			* \param[out] pBlocks	block_of() of each position.
+			* \param[out] pOffsets	offset_of() of each position.
+			*/
+			static void translate(const std::uint64_t* pPositions, std::size_t uCount, unsigned* pBlocks, std::uint64_t* pOffsets) noexcept
+			{
+				std::size_t i = 0;
+#if defined(BVL_HAS_AVX512CD)
+				const __m512i vFirst = _mm512_set1_epi64(static_cast<long long>(first_block_size));
+				const __m512i v63 = _mm512_set1_epi64(63);
+				const __m512i vOne = _mm512_set1_epi64(1);
+				for (; uCount - i >= 8; i += 8)
+				{
+					__m512i q = _mm512_add_epi64(_mm512_loadu_si512(pPositions + i), vFirst);
+					__m512i e = _mm512_sub_epi64(v63, _mm512_lzcnt_epi64(q));
+					//the zero masked forms because the unmasked ones trip -Wmaybe-uninitialized in some GCC versions
+					_mm512_storeu_si512(pOffsets + i, _mm512_sub_epi64(q, _mm512_maskz_sllv_epi64(0xFF, vOne, e)));
+					__m256i k = _mm512_maskz_cvtepi64_epi32(0xFF, _mm512_sub_epi64(e, _mm512_set1_epi64(FirstBlockLog2)));
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(pBlocks + i), k);
+				}
+#elif defined(BVL_HAS_AVX2)
+				const __m256i vFirst = _mm256_set1_epi64x(static_cast<long long>(first_block_size));
+				const __m256i vTwo52 = _mm256_set1_epi64x(0x4330000000000000LL);
+				const __m256i vHigh = _mm256_set1_epi64x(static_cast<long long>(~((std::uint64_t(1) << 52) - 1)));
+				const __m256i vBias = _mm256_set1_epi64x(1023 + FirstBlockLog2);
+				const __m256i vOne = _mm256_set1_epi64x(1);
+				const __m256i vEven = _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0);
+				for (; uCount - i >= 4; i += 4)
+				{
+					__m256i q = _mm256_add_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pPositions + i)), vFirst);
+					if (!_mm256_testz_si256(q, vHigh))
+					{
+						break;
+					}
+					//q | 2^52 as a double is 2^52 + q, subtracting 2^52 leaves q exactly, with its floor(log2) in the exponent
+					__m256d d = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(q, vTwo52)), _mm256_castsi256_pd(vTwo52));
+					__m256i e = _mm256_srli_epi64(_mm256_castpd_si256(d), 52);
+					__m256i k = _mm256_sub_epi64(e, vBias);
+					//e - 1023 is floor(log2(q)), so the block start is 1 << (k + FirstBlockLog2)
+					__m256i vStart = _mm256_sllv_epi64(vOne, _mm256_add_epi64(k, _mm256_set1_epi64x(FirstBlockLog2)));
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(pOffsets + i), _mm256_sub_epi64(q, vStart));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(pBlocks + i), _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(k, vEven)));
+				}
+#endif
+				for (; i < uCount; ++i)
+				{
+					pBlocks[i] = block_of(pPositions[i]);
+					pOffsets[i] = offset_of(pPositions[i], pBlocks[i]);
+				}
+			}
+		};
+	}
+
+	/**
+	* \brief Allocator that aligns every allocation, for lists whose blocks are processed with aligned SIMD loads.
+	* Allocations of page_threshold bytes or more are aligned to at least page_size, so the large doubling blocks start on a page.
+	* Blocks never share a cache line with each other or with anything else, as long as Alignment is at least the cache line size.
+	* \tparam T			The type of object allocated.
+	* \tparam Alignment	Alignment of every allocation. A power of two, 64 (the cache line size) by default.
+	*/
+	template<typename T, std::size_t Alignment = 64>
+	class AlignedAllocator
+	{
+		static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0, "AlignedAllocator: Alignment must be a power of two");
+
+	public:
+		typedef T value_type;
+		typedef std::true_type is_always_equal;
+
+		/**
+		* Alignment of every allocation
+		*/
+		static const std::size_t alignment = Alignment < alignof(T) ? alignof(T) : Alignment;
+
+		/**
+		* Alignment of large allocations
+		*/
+		static const std::size_t page_size = 4096;
+
+		/**
+		* Allocations of at least this many bytes are page aligned
+		*/
+		static const std::size_t page_threshold = 16 * page_size;
+
+		template<typename U>
+		struct rebind
+		{
+			typedef AlignedAllocator<U, Alignment> other;
+		};
+
+		AlignedAllocator() noexcept {}
+		template<typename U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+		/**
+		* \brief Allocates uninitialized storage for n objects
+		* \throw std::bad_alloc if the storage can not be allocated
+		*/
+		T* allocate(std::size_t n)
+		{
+			if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+			{
+				throw std::bad_alloc();
+			}
+			std::size_t uBytes = n * sizeof(T);
+			std::size_t uAlign = alignment_for(uBytes);
+#if defined(__cpp_aligned_new)
+			return static_cast<T*>(::operator new(uBytes, std::align_val_t(uAlign)));
+#else
+			//over allocate, and keep the pointer that was allocated just before the aligned one
+			if (uBytes > std::numeric_limits<std::size_t>::max() - uAlign)
+			{
+				throw std::bad_alloc();
+			}
+			char* pRaw = static_cast<char*>(::operator new(uBytes + uAlign));
+			char* pAligned = pRaw + uAlign - (reinterpret_cast<std::uintptr_t>(pRaw) & (uAlign - 1));
+			reinterpret_cast<void**>(pAligned)[-1] = pRaw;
+			return reinterpret_cast<T*>(pAligned);
+#endif
+		}
+
+		/**
+		* \brief Deallocates storage returned by allocate(n)
+		*/
+		void deallocate(T* p, std::size_t n) noexcept
+		{
+#if defined(__cpp_aligned_new)
+			::operator delete(p, std::align_val_t(alignment_for(n * sizeof(T))));
+#else
+			(void)n;
+			::operator delete(reinterpret_cast<void**>(p)[-1]);
+#endif
+		}
+
+		friend bool operator==(const AlignedAllocator&, const AlignedAllocator&) noexcept { return true; }
+		friend bool operator!=(const AlignedAllocator&, const AlignedAllocator&) noexcept { return false; }
+
+	private:
+		static std::size_t alignment_for(std::size_t uBytes) noexcept
+		{
+			//the pointer stored before the block needs the alignment to be at least a pointer's
+			std::size_t uAlign = alignment < sizeof(void*) ? sizeof(void*) : alignment;
+			return uBytes >= page_threshold && uAlign < page_size ? page_size : uAlign;
+		}
+	};
+
+	namespace detail
+	{
+		/**
+		* \brief Whether Alloc constructs with plain placement new, so trivially copyable elements may be copied with memcpy instead
+		*/
+		template<typename Alloc>
+		struct is_placement_allocator : std::false_type {};
+
+		template<typename T>
+		struct is_placement_allocator<std::allocator<T> > : std::true_type {};
+
+		template<typename T, std::size_t Alignment>
+		struct is_placement_allocator<AlignedAllocator<T, Alignment> > : std::true_type {};
+
+		/**
+		* \brief Whether Alloc promises every block its own alignment, which packing the blocks back to back in one array would break
+		*/
+		template<typename Alloc>
+		struct aligns_blocks : std::false_type {};
+
+		template<typename T, std::size_t Alignment>
+		struct aligns_blocks<AlignedAllocator<T, Alignment> > : std::true_type {};
+	}
+
+	/**
+	* \brief Random access iterator over the blocks of a BinaryVectorList.
+	* Keeps a pointer to the current element so that dereferencing and stepping within a block costs the same as a pointer,
+	* and only goes back to the block table when it crosses a block boundary.
+	* Stepping forward prefetches the start of the next block prefetch_ahead elements before reaching it,
+	* since the hardware prefetcher can not follow the jump to a block somewhere else in memory.
+	* \tparam list_type The BinaryVectorList being iterated (const qualified for const iterators).
+	* \tparam iterator_type The element type (const qualified for const iterators).
+	*/
+	template<typename list_type, typename iterator_type>
+	class BinaryVectorListIterator
+	{
+	public:
+		typedef std::random_access_iterator_tag iterator_category;
+		typedef typename std::remove_const<iterator_type>::type value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef iterator_type* pointer;
+		typedef iterator_type& reference;
+
+		/**
+		* How many elements (about 4 cache lines) before a block boundary its next block is prefetched
+		*/
+		static const std::size_t prefetch_ahead = sizeof(value_type) < 256 ? 256 / sizeof(value_type) : 1;
+
+		BVL_CONSTEXPR20 BinaryVectorListIterator() : m_pList(nullptr), m_uIndex(0), m_pCur(nullptr) {}
+		BVL_CONSTEXPR20 BinaryVectorListIterator(list_type* pList, std::size_t uIndex) : m_pList(pList), m_uIndex(uIndex), m_pCur(pList->locate(uIndex))
+		{
+#if BVL_HARDENED
+			m_uGeneration = pList->m_uGeneration;
+#endif
+		}
+
+		/**
+		* \brief Converting constructor, allows an iterator to be used where a const_iterator is expected
+		*/
+		template<typename other_list_type, typename other_iterator_type,
+			typename = typename std::enable_if<std::is_convertible<other_iterator_type*, iterator_type*>::value>::type>
+		BVL_CONSTEXPR20 BinaryVectorListIterator(const BinaryVectorListIterator<other_list_type, other_iterator_type>& rhs) : m_pList(rhs.m_pList), m_uIndex(rhs.m_uIndex), m_pCur(rhs.m_pCur)
+		{
+#if BVL_HARDENED
+			m_uGeneration = rhs.m_uGeneration;
+#endif
+		}
+
+		BVL_CONSTEXPR20 BinaryVectorListIterator& operator+=(difference_type rhs) { m_uIndex += rhs; m_pCur = m_pList->locate(m_uIndex); return *this; }
+		BVL_CONSTEXPR20 BinaryVectorListIterator& operator-=(difference_type rhs) { m_uIndex -= rhs; m_pCur = m_pList->locate(m_uIndex); return *this; }
+		BVL_CONSTEXPR20 reference operator*() const { check_dereferenceable(); return *m_pCur; }
+		BVL_CONSTEXPR20 pointer operator->() const { check_dereferenceable(); return m_pCur; }
+		BVL_CONSTEXPR20 reference operator[](difference_type rhs) const { return *(*this + rhs); }
+
+		/**
+		* \brief Number of elements from this one to the end of its block, which are contiguous in memory
+		*/
+		BVL_CONSTEXPR20 std::size_t contiguous() const noexcept
+		{
+			typedef typename std::remove_const<list_type>::type::layout layout;
+			return static_cast<std::size_t>(layout::block_start(layout::block_of(m_uIndex) + 1) - m_uIndex);
+		}
+
+		BVL_CONSTEXPR20 BinaryVectorListIterator& operator++()
+		{
+			++m_uIndex;
+			++m_pCur;
+			if (list_type::is_block_start(m_uIndex + prefetch_ahead))
+			{
+				m_pList->prefetch(m_uIndex + prefetch_ahead);
+			}
+			if (list_type::is_block_start(m_uIndex))
+			{
+				m_pCur = m_pList->locate(m_uIndex);
+			}
+			return *this;
+		}
+
+		BVL_CONSTEXPR20 BinaryVectorListIterator& operator--()
+		{
+			if (list_type::is_block_start(m_uIndex))
+			{
+				--m_uIndex;
+				m_pCur = m_pList->locate(m_uIndex);
+			}
+			else
+			{
+				--m_uIndex;
+				--m_pCur;
+			}
+			return *this;
+		}
+
+		BVL_CONSTEXPR20 BinaryVectorListIterator operator++(int) { BinaryVectorListIterator tmp(*this); ++*this; return tmp; }
+		BVL_CONSTEXPR20 BinaryVectorListIterator operator--(int) { BinaryVectorListIterator tmp(*this); --*this; return tmp; }
+		BVL_CONSTEXPR20 difference_type operator-(const BinaryVectorListIterator& rhs) const { check_comparable(*this, rhs); return static_cast<difference_type>(m_uIndex - rhs.m_uIndex); }
+		BVL_CONSTEXPR20 BinaryVectorListIterator operator+(difference_type rhs) const { BinaryVectorListIterator tmp(*this); return tmp += rhs; }
+		BVL_CONSTEXPR20 BinaryVectorListIterator operator-(difference_type rhs) const { BinaryVectorListIterator tmp(*this); return tmp -= rhs; }
+		friend BVL_CONSTEXPR20 BinaryVectorListIterator operator+(difference_type lhs, const BinaryVectorListIterator& rhs) { return rhs + lhs; }
+
+		friend BVL_CONSTEXPR20 bool operator==(const BinaryVectorListIterator& lhs, const BinaryVectorListIterator& rhs) { check_comparable(lhs, rhs); return lhs.m_uIndex == rhs.m_uIndex; }
+		friend BVL_CONSTEXPR20 bool operator!=(const BinaryVectorListIterator& lhs, const BinaryVectorListIterator& rhs) { check_comparable(lhs, rhs); return lhs.m_uIndex != rhs.m_uIndex; }
+		friend BVL_CONSTEXPR20 bool operator>(const BinaryVectorListIterator& lhs, const BinaryVectorListIterator& rhs) { check_comparable(lhs, rhs); return lhs.m_uIndex > rhs.m_uIndex; }
+		friend BVL_CONSTEXPR20 bool operator<(const BinaryVectorListIterator& lhs, const BinaryVectorListIterator& rhs) { check_comparable(lhs, rhs); return lhs.m_uIndex < rhs.m_uIndex; }
+		friend BVL_CONSTEXPR20 bool operator>=(const BinaryVectorListIterator& lhs, const BinaryVectorListIterator& rhs) { check_comparable(lhs, rhs); return lhs.m_uIndex >= rhs.m_uIndex; }
+		friend BVL_CONSTEXPR20 bool operator<=(const BinaryVectorListIterator& lhs, const BinaryVectorListIterator& rhs) { check_comparable(lhs, rhs); return lhs.m_uIndex <= rhs.m_uIndex; }
+
+	private:
+		template<typename, typename> friend class BinaryVectorListIterator;
+
+		/**
+		* \brief In hardened mode, checks that the iterator points at an element of a list that has not invalidated it
+		*/
+		BVL_CONSTEXPR20 void check_dereferenceable() const noexcept
+		{
+			BVL_HARDENED_CHECK(m_pList != nullptr, "dereferencing a singular iterator");
+			BVL_HARDENED_CHECK(m_uGeneration == m_pList->m_uGeneration, "using an iterator invalidated by erase, insert, clear or swap");
+			BVL_HARDENED_CHECK(m_uIndex < m_pList->size() && m_pCur != nullptr, "dereferencing an iterator outside of the list");
+		}
+
+		/**
+		* \brief In hardened mode, checks that two iterators belong to the same list
+		*/
+		static BVL_CONSTEXPR20 void check_comparable(const BinaryVectorListIterator& lhs, const BinaryVectorListIterator& rhs) noexcept
+		{
+			BVL_HARDENED_CHECK(lhs.m_pList == rhs.m_pList, "comparing iterators of different lists");
+			(void)lhs;
+			(void)rhs;
+		}
+
+		list_type* m_pList;
+		std::size_t m_uIndex;
+		iterator_type* m_pCur;
+#if BVL_HARDENED
+		std::size_t m_uGeneration = 0;
+#endif
+	};
+
+	/**
+	* \brief Random access iterator for containers that hand out elements by value or through a proxy (BinaryVectorList<bool>).
+	* Every dereference goes through the container's operator[].
+	* \tparam list_type The container being iterated (const qualified for const iterators). It must define value_type.
+	* \tparam reference_type What dereferencing yields (a proxy or a value).
+	*/
+	template<typename list_type, typename reference_type>
+	class BinaryVectorListIndexIterator
+	{
+	public:
+		typedef std::random_access_iterator_tag iterator_category;
+		typedef typename std::remove_const<list_type>::type::value_type value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef void pointer;
+		typedef reference_type reference;
+
+		BVL_CONSTEXPR20 BinaryVectorListIndexIterator() : m_pList(nullptr), m_uIndex(0) {}
+		BVL_CONSTEXPR20 BinaryVectorListIndexIterator(list_type* pList, std::size_t uIndex) : m_pList(pList), m_uIndex(uIndex) {}
+
+		/**
+		* \brief Converting constructor, allows an iterator to be used where a const_iterator is expected
+		*/
+		template<typename other_list_type, typename other_reference_type,
+			typename = typename std::enable_if<std::is_convertible<other_list_type*, list_type*>::value>::type>
+		BVL_CONSTEXPR20 BinaryVectorListIndexIterator(const BinaryVectorListIndexIterator<other_list_type, other_reference_type>& rhs) : m_pList(rhs.m_pList), m_uIndex(rhs.m_uIndex) {}
+
+		BVL_CONSTEXPR20 BinaryVectorListIndexIterator& operator+=(difference_type rhs) { m_uIndex += rhs; return *this; }
+		BVL_CONSTEXPR20 BinaryVectorListIndexIterator& operator-=(difference_type rhs) { m_uIndex -= rhs; return *this; }
+		BVL_CONSTEXPR20 reference operator*() const { return (*m_pList)[m_uIndex]; }
+		BVL_CONSTEXPR20 reference operator[](difference_type rhs) const { return (*m_pList)[m_uIndex + rhs]; }
+
+		BVL_CONSTEXPR20 BinaryVectorListIndexIterator& operator++() { ++m_uIndex; return *this; }
+		BVL_CONSTEXPR20 BinaryVectorListIndexIterator& operator--() { --m_uIndex; return *this; }
+		BVL_CONSTEXPR20 BinaryVectorListIndexIterator operator++(int) { BinaryVectorListIndexIterator tmp(*this); ++m_uIndex; return tmp; }
+		BVL_CONSTEXPR20 BinaryVectorListIndexIterator operator--(int) { BinaryVectorListIndexIterator tmp(*this); --m_uIndex; return tmp; }
+		BVL_CONSTEXPR20 difference_type operator-(const BinaryVectorListIndexIterator& rhs) const { check_comparable(*this, rhs); return static_cast<difference_type>(m_uIndex - rhs.m_uIndex); }
+		BVL_CONSTEXPR20 BinaryVectorListIndexIterator operator+(difference_type rhs) const { return BinaryVectorListIndexIterator(m_pList, m_uIndex + rhs); }
+		BVL_CONSTEXPR20 BinaryVectorListIndexIterator operator-(difference_type rhs) const { return BinaryVectorListIndexIterator(m_pList, m_uIndex - rhs); }
+		friend BVL_CONSTEXPR20 BinaryVectorListIndexIterator operator+(difference_type lhs, const BinaryVectorListIndexIterator& rhs) { return rhs + lhs; }
+
+		friend BVL_CONSTEXPR20 bool operator==(const BinaryVectorListIndexIterator& lhs, const BinaryVectorListIndexIterator& rhs) { check_comparable(lhs, rhs); return lhs.m_uIndex == rhs.m_uIndex; }
+		friend BVL_CONSTEXPR20 bool operator!=(const BinaryVectorListIndexIterator& lhs, const BinaryVectorListIndexIterator& rhs) { check_comparable(lhs, rhs); return lhs.m_uIndex != rhs.m_uIndex; }
+		friend BVL_CONSTEXPR20 bool operator>(const BinaryVectorListIndexIterator& lhs, const BinaryVectorListIndexIterator& rhs) { check_comparable(lhs, rhs); return lhs.m_uIndex > rhs.m_uIndex; }
+		friend BVL_CONSTEXPR20 bool operator<(const BinaryVectorListIndexIterator& lhs, const BinaryVectorListIndexIterator& rhs) { check_comparable(lhs, rhs); return lhs.m_uIndex < rhs.m_uIndex; }
+		friend BVL_CONSTEXPR20 bool operator>=(const BinaryVectorListIndexIterator& lhs, const BinaryVectorListIndexIterator& rhs) { check_comparable(lhs, rhs); return lhs.m_uIndex >= rhs.m_uIndex; }
+		friend BVL_CONSTEXPR20 bool operator<=(const BinaryVectorListIndexIterator& lhs, const BinaryVectorListIndexIterator& rhs) { check_comparable(lhs, rhs); return lhs.m_uIndex <= rhs.m_uIndex; }
+
+	private:
+		template<typename, typename> friend class BinaryVectorListIndexIterator;
+
+		/**
+		* \brief In hardened mode, checks that two iterators belong to the same list
+		*/
+		static BVL_CONSTEXPR20 void check_comparable(const BinaryVectorListIndexIterator& lhs, const BinaryVectorListIndexIterator& rhs) noexcept
+		{
+			BVL_HARDENED_CHECK(lhs.m_pList == rhs.m_pList, "comparing iterators of different lists");
+			(void)lhs;
+			(void)rhs;
+		}
+
+		list_type* m_pList;
+		std::size_t m_uIndex;
+	};
+
+	/**
+	* \brief A long lived position in a BinaryVectorList.
+	* Holds a logical index together with the block and address of its element. The address is reused for as long as
+	* the list's modification counter is unchanged and is looked up again from the index when it has moved.
+	* push_back never moves an element (outside of a contiguous limit) and leaves the counter alone, so reading through a cursor into a list that grows
+	* at the end costs one comparison and a pointer dereference.
+	* push_front and pop_front shift every element by one. The list keeps count of them and the cursor applies the difference
+	* when it revalidates, so it stays on the same element. After any other insert or erase it keeps its index.
+	* A cursor may sit at or past the end, and reads the elements appended there once they exist.
+	* \tparam list_type The BinaryVectorList (const qualified for const cursors).
+	* \tparam element_type The element type (const qualified for const cursors).
+	*/
+	template<typename list_type, typename element_type>
+	class BinaryVectorListCursor
+	{
+	public:
+		typedef typename std::remove_const<element_type>::type value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef element_type* pointer;
+		typedef element_type& reference;
+
+		BVL_CONSTEXPR20 BinaryVectorListCursor() : m_pList(nullptr), m_uIndex(0), m_uBlock(0), m_pCur(nullptr), m_uGeneration(0), m_uFrontShift(0) {}
+		BVL_CONSTEXPR20 BinaryVectorListCursor(list_type* pList, std::size_t uIndex) : m_pList(pList), m_uIndex(uIndex), m_uBlock(0), m_pCur(nullptr), m_uGeneration(0), m_uFrontShift(pList->m_uFrontShift)
+		{
+			revalidate();
+		}
+
+		/**
+		* \brief Converting constructor, allows a cursor to be used where a const_cursor is expected
+		*/
+		template<typename other_list_type, typename other_element_type,
+			typename = typename std::enable_if<std::is_convertible<other_element_type*, element_type*>::value>::type>
+		BVL_CONSTEXPR20 BinaryVectorListCursor(const BinaryVectorListCursor<other_list_type, other_element_type>& rhs)
+			: m_pList(rhs.m_pList), m_uIndex(rhs.m_uIndex), m_uBlock(rhs.m_uBlock), m_pCur(rhs.m_pCur), m_uGeneration(rhs.m_uGeneration), m_uFrontShift(rhs.m_uFrontShift)
+		{
+		}
+
+		/**
+		* \brief The current index of the element, counting any push_front or pop_front since the cursor was made
+		*/
+		BVL_CONSTEXPR20 std::size_t index() const noexcept
+		{
+			return m_uIndex + (m_pList->m_uFrontShift - m_uFrontShift);
+		}
+
+		/**
+		* \brief Whether the cursor is on an element, rather than at or past the end or before a pop_front removed its element
+		*/
+		BVL_CONSTEXPR20 bool valid() const noexcept
+		{
+			return m_pList != nullptr && index() < m_pList->size();
+		}
+
+		BVL_CONSTEXPR20 reference operator*() const { return *get(); }
+		BVL_CONSTEXPR20 pointer operator->() const { return get(); }
+
+		BVL_CONSTEXPR20 BinaryVectorListCursor& operator++()
+		{
+			if (m_uGeneration != m_pList->m_uGeneration)
+			{
+				revalidate();
+			}
+			++m_uIndex;
+			if (!m_pCur)
+			{
+				revalidate();
+			}
+			else if (!layout::is_block_start(m_uIndex))
+			{
+				++m_pCur;
+			}
+			else
+			{
+				++m_uBlock;
+				m_pCur = m_uBlock < m_pList->m_uBlocks ? std::addressof(m_pList->m_apBlocks[m_uBlock][0]) : nullptr;
+			}
+			return *this;
+		}
+
+		BVL_CONSTEXPR20 BinaryVectorListCursor& operator--()
+		{
+			if (m_uGeneration != m_pList->m_uGeneration)
+			{
+				revalidate();
+			}
+			if (m_pCur && !layout::is_block_start(m_uIndex))
+			{
+				--m_uIndex;
+				--m_pCur;
+			}
+			else
+			{
+				--m_uIndex;
+				revalidate();
+			}
+			return *this;
+		}
+
+		BVL_CONSTEXPR20 BinaryVectorListCursor operator++(int) { BinaryVectorListCursor tmp(*this); ++*this; return tmp; }
+		BVL_CONSTEXPR20 BinaryVectorListCursor operator--(int) { BinaryVectorListCursor tmp(*this); --*this; return tmp; }
+		BVL_CONSTEXPR20 BinaryVectorListCursor& operator+=(difference_type rhs) { m_uIndex = index() + rhs; revalidate(); return *this; }
+		BVL_CONSTEXPR20 BinaryVectorListCursor& operator-=(difference_type rhs) { m_uIndex = index() - rhs; revalidate(); return *this; }
+
+	private:
+		template<typename, typename> friend class BinaryVectorListCursor;
+
+		typedef typename std::remove_const<list_type>::type::layout layout;
+
+		/**
+		* \brief Address of the element, looked up again only if the list has moved elements since it was cached
+		*/
+		BVL_CONSTEXPR20 pointer get() const
+		{
+			if (m_uGeneration != m_pList->m_uGeneration || !m_pCur)
+			{
+				revalidate();
+			}
+			BVL_HARDENED_CHECK(m_uIndex < m_pList->size(), "dereferencing a cursor outside of the list");
+			return m_pCur;
+		}
+
+		/**
+		* \brief Applies the push_front/pop_front count to the index and looks up its block and address.
+		* The address is left null if the index is past the allocated blocks.
+		*/
+		BVL_CONSTEXPR20 void revalidate() const noexcept
+		{
+			m_uIndex += m_pList->m_uFrontShift - m_uFrontShift;
+			m_uFrontShift = m_pList->m_uFrontShift;
+			m_uGeneration = m_pList->m_uGeneration;
+			if (m_uIndex < m_pList->capacity())
+			{
+				m_uBlock = layout::block_of(m_uIndex);
+				m_pCur = std::addressof(m_pList->m_apBlocks[m_uBlock][static_cast<std::size_t>(layout::offset_of(m_uIndex, m_uBlock))]);
+			}
+			else
+			{
+				m_pCur = nullptr;
+			}
+		}
+
+		list_type* m_pList;
+		//The rest is a cache that revalidate() refreshes, including on const access
+		mutable std::size_t m_uIndex;
+		mutable unsigned m_uBlock;
+		mutable pointer m_pCur;
+		mutable std::size_t m_uGeneration;
+		mutable std::size_t m_uFrontShift;
+	};
+
+	/**
+	* \brief One block of a BinaryVectorList, or the used part of the last block, as a contiguous range.
+	* begin() and end() are plain pointers, so a loop over a chunk vectorizes like a loop over an array.
+	* \tparam element_type The element type (const qualified for chunks of a const list).
+	*/
+	template<typename element_type>
+	class BinaryVectorListChunk
+	{
+	public:
+		typedef typename std::remove_const<element_type>::type value_type;
+		typedef std::size_t size_type;
+		typedef element_type* pointer;
+		typedef element_type* iterator;
+		typedef element_type& reference;
+
+		BVL_CONSTEXPR20 BinaryVectorListChunk() noexcept : m_pFirst(nullptr), m_uSize(0) {}
+		BVL_CONSTEXPR20 BinaryVectorListChunk(pointer pFirst, size_type uSize) noexcept : m_pFirst(pFirst), m_uSize(uSize) {}
+
+		BVL_CONSTEXPR20 iterator begin() const noexcept { return m_pFirst; }
+		BVL_CONSTEXPR20 iterator end() const noexcept { return m_pFirst + m_uSize; }
+		BVL_CONSTEXPR20 pointer data() const noexcept { return m_pFirst; }
+		BVL_CONSTEXPR20 size_type size() const noexcept { return m_uSize; }
+		BVL_CONSTEXPR20 bool empty() const noexcept { return m_uSize == 0; }
+		BVL_CONSTEXPR20 reference operator[](size_type n) const { return m_pFirst[n]; }
+
+	private:
+		pointer m_pFirst;
+		size_type m_uSize;
+	};
+
+	/**
+	* \brief The blocks of a BinaryVectorList as a random access range of BinaryVectorListChunk, see BinaryVectorList::chunks().
+	* It refers to the list and is as cheap to copy as a pair of pointers.
+	* \tparam list_type The BinaryVectorList (const qualified for a const list).
+	* \tparam element_type The element type (const qualified for a const list).
+	*/
+	template<typename list_type, typename element_type>
+	class BinaryVectorListChunks
+	{
+	public:
+		typedef BinaryVectorListChunk<element_type> value_type;
+		typedef std::size_t size_type;
+
+		/**
+		* \brief Iterator over the chunks. Dereferencing makes the chunk, so it is an input iterator to pre C++20 algorithms
+		* and a random access iterator to C++20 ranges.
+		*/
+		class iterator
+		{
+		public:
+			typedef std::input_iterator_tag iterator_category;
+			typedef std::random_access_iterator_tag iterator_concept;
+			typedef BinaryVectorListChunk<element_type> value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef void pointer;
+			typedef value_type reference;
+
+			BVL_CONSTEXPR20 iterator() noexcept : m_pList(nullptr), m_uBlock(0) {}
+			BVL_CONSTEXPR20 iterator(list_type* pList, unsigned uBlock) noexcept : m_pList(pList), m_uBlock(uBlock) {}
+
+			BVL_CONSTEXPR20 value_type operator*() const { return m_pList->chunk(m_uBlock); }
+			BVL_CONSTEXPR20 value_type operator[](difference_type rhs) const { return *(*this + rhs); }
+
+			BVL_CONSTEXPR20 iterator& operator++() noexcept { ++m_uBlock; return *this; }
+			BVL_CONSTEXPR20 iterator& operator--() noexcept { --m_uBlock; return *this; }
+			BVL_CONSTEXPR20 iterator operator++(int) noexcept { iterator tmp(*this); ++m_uBlock; return tmp; }
+			BVL_CONSTEXPR20 iterator operator--(int) noexcept { iterator tmp(*this); --m_uBlock; return tmp; }
+			BVL_CONSTEXPR20 iterator& operator+=(difference_type rhs) noexcept { m_uBlock = static_cast<unsigned>(m_uBlock + rhs); return *this; }
+			BVL_CONSTEXPR20 iterator& operator-=(difference_type rhs) noexcept { m_uBlock = static_cast<unsigned>(m_uBlock - rhs); return *this; }
+			BVL_CONSTEXPR20 iterator operator+(difference_type rhs) const noexcept { iterator tmp(*this); return tmp += rhs; }
+			BVL_CONSTEXPR20 iterator operator-(difference_type rhs) const noexcept { iterator tmp(*this); return tmp -= rhs; }
+			BVL_CONSTEXPR20 difference_type operator-(const iterator& rhs) const noexcept { return static_cast<difference_type>(m_uBlock) - static_cast<difference_type>(rhs.m_uBlock); }
+			friend BVL_CONSTEXPR20 iterator operator+(difference_type lhs, const iterator& rhs) noexcept { return rhs + lhs; }
+
+			friend BVL_CONSTEXPR20 bool operator==(const iterator& lhs, const iterator& rhs) noexcept { return lhs.m_uBlock == rhs.m_uBlock; }
+			friend BVL_CONSTEXPR20 bool operator!=(const iterator& lhs, const iterator& rhs) noexcept { return lhs.m_uBlock != rhs.m_uBlock; }
+			friend BVL_CONSTEXPR20 bool operator>(const iterator& lhs, const iterator& rhs) noexcept { return lhs.m_uBlock > rhs.m_uBlock; }
+			friend BVL_CONSTEXPR20 bool operator<(const iterator& lhs, const iterator& rhs) noexcept { return lhs.m_uBlock < rhs.m_uBlock; }
+			friend BVL_CONSTEXPR20 bool operator>=(const iterator& lhs, const iterator& rhs) noexcept { return lhs.m_uBlock >= rhs.m_uBlock; }
+			friend BVL_CONSTEXPR20 bool operator<=(const iterator& lhs, const iterator& rhs) noexcept { return lhs.m_uBlock <= rhs.m_uBlock; }
+
+		private:
+			list_type* m_pList;
+			unsigned m_uBlock;
+		};
+
+		BVL_CONSTEXPR20 BinaryVectorListChunks() noexcept : m_pList(nullptr) {}
+		BVL_CONSTEXPR20 explicit BinaryVectorListChunks(list_type* pList) noexcept : m_pList(pList) {}
+
+		BVL_CONSTEXPR20 iterator begin() const noexcept { return iterator(m_pList, 0); }
+		BVL_CONSTEXPR20 iterator end() const noexcept { return iterator(m_pList, static_cast<unsigned>(size())); }
+		BVL_CONSTEXPR20 size_type size() const noexcept { return m_pList ? m_pList->chunk_count() : 0; }
+		BVL_CONSTEXPR20 bool empty() const noexcept { return size() == 0; }
+		BVL_CONSTEXPR20 value_type operator[](size_type n) const { return m_pList->chunk(static_cast<unsigned>(n)); }
+
+	private:
+		list_type* m_pList;
+	};
+
+	namespace detail
+	{
+		/**
+		* \brief Most elements in one unit of work of the parallel algorithms
+		*/
+		const std::size_t parallel_grain = std::size_t(1) << 16;
+
+		/**
+		* \brief A run of consecutive positions, relative to the start of the range
+		*/
+		struct position_span
+		{
+			std::size_t uStart;
+			std::size_t uCount;
+		};
+
+		/**
+		* \brief Threads worth using for uCount elements, at least 1
+		*/
+		inline std::size_t parallel_threads(std::size_t uCount, std::size_t uThreads) noexcept
+		{
+			return std::max(std::size_t(1), std::min(uThreads, uCount / parallel_grain));
+		}
+
+		/**
+		* \brief Calls work(i) for every i in [0, uItems) on uThreads threads. Each thread takes the next i when it finishes one.
+		* An exception from work is rethrown once every thread has stopped.
+		*/
+		template<typename Work>
+		void parallel_for(std::size_t uItems, std::size_t uThreads, Work work)
+		{
+			std::atomic<std::size_t> uNext(0);
+			auto worker = [&uNext, uItems, &work]()
+			{
+				for (std::size_t i = uNext++; i < uItems; i = uNext++)
+				{
+					work(i);
+				}
+			};
+			std::vector<std::future<void> > vfParts;
+			for (std::size_t t = 1; t < uThreads; ++t)
+			{
+				vfParts.push_back(std::async(std::launch::async, worker));
+			}
+			worker();
+			for (std::future<void>& fPart : vfParts)
+			{
+				fPart.get();
+			}
+		}
+
+		/**
+		* \brief Cuts the uCount positions from first into runs that stay inside a block and hold at most parallel_grain elements
+		*/
+		template<typename list_type, typename element_type>
+		std::vector<position_span> split_runs(BinaryVectorListIterator<list_type, element_type> first, std::size_t uCount)
+		{
+			std::vector<position_span> vRuns;
+			for (std::size_t uStart = 0; uStart < uCount; )
+			{
+				std::size_t uRun = std::min(std::min(uCount - uStart, (first + static_cast<std::ptrdiff_t>(uStart)).contiguous()), parallel_grain);
+				vRuns.push_back(position_span{uStart, uRun});
+				uStart += uRun;
+			}
+			return vRuns;
+		}
+
+		/**
+		* \brief Maps a radix_sort key to an unsigned integer of the same size that orders the same way.
+		* Only integral (other than bool) and floating point keys have one.
+		*/
+		template<typename key_type, typename = void>
+		struct radix_key;
+
+		template<typename key_type>
+		struct radix_key<key_type, typename std::enable_if<std::is_integral<key_type>::value && !std::is_same<key_type, bool>::value>::type>
+		{
+			typedef typename std::make_unsigned<key_type>::type unsigned_type;
+
+			static unsigned_type encode(key_type key) noexcept
+			{
+				//Setting the sign bit of the positive values and clearing it on the negative ones puts the negative values first
+				return static_cast<unsigned_type>(static_cast<unsigned_type>(key) ^ (std::is_signed<key_type>::value ? unsigned_type(1) << (sizeof(unsigned_type) * 8 - 1) : 0));
+			}
+		};
+
+		template<typename key_type>
+		struct radix_key<key_type, typename std::enable_if<std::is_floating_point<key_type>::value>::type>
+		{
+			static_assert(sizeof(key_type) == 4 || sizeof(key_type) == 8, "radix_sort() supports 32 and 64 bit floating point keys");
+			typedef typename std::conditional<sizeof(key_type) == 4, std::uint32_t, std::uint64_t>::type unsigned_type;
+
+			static unsigned_type encode(key_type key) noexcept
+			{
+				unsigned_type uBits;
+				std::memcpy(&uBits, &key, sizeof(uBits));
+				//Larger negative values have larger bits, so every bit of a negative value flips; positive values only gain the sign bit
+				return uBits >> (sizeof(unsigned_type) * 8 - 1) ? static_cast<unsigned_type>(~uBits) : static_cast<unsigned_type>(uBits | (unsigned_type(1) << (sizeof(unsigned_type) * 8 - 1)));
+			}
+		};
+	}
+}
+
+#if defined(__cpp_lib_ranges)
+/**
+* A chunk and the chunks range only refer to the list, so they are views, and the ranges they hand out outlive them.
+*/
+template<typename element_type>
+inline constexpr bool std::ranges::enable_view<bvl::BinaryVectorListChunk<element_type>> = true;
+template<typename element_type>
+inline constexpr bool std::ranges::enable_borrowed_range<bvl::BinaryVectorListChunk<element_type>> = true;
+template<typename list_type, typename element_type>
+inline constexpr bool std::ranges::enable_view<bvl::BinaryVectorListChunks<list_type, element_type>> = true;
+template<typename list_type, typename element_type>
+inline constexpr bool std::ranges::enable_borrowed_range<bvl::BinaryVectorListChunks<list_type, element_type>> = true;
+#endif
+
+/**
+* \brief A v-list implementation the array abstract data structure.
+* It's API is a combination of those of std::vector and std::list with a few exceptions.
+* Anything asymptotically slower than linear with respect to container size from the std::list API is not provided.
+* This is a way from keeping users from doing stupid (slow) things, and blaming the data structure.
+* The goal here is to use an implementation free interface to develop a new implementation for the array abstract data structure,
+* that is the implementation details can vary from each individual implementor, but the API/interface remain the same.
+* std::vector.data() assumes that the elements are 1 continuous block of memory, which this implementation normally breaks,
+* so whether data() is usable is a run time question: is_contiguous() is true for a list of 1 block or after compact()
+* (except with AlignedAllocator, whose blocks stay separate so that each one keeps its alignment).
+* BinaryVectorList can be used exactly like std::vector (except that data() may return nullptr)
+* including having constant time Random Access Iterators, leveraging some spacial locality of elements,
+* but it should be asymptotically faster on inserts at the end than std::vector.
+* The downside is that it uses less spacial locality than std::vector
+* by using several different sized blocks of continuous memory instead of just 1.
+* Elements are stored in a list of blocks where each block is twice the size of the one before it (see bvl::detail::BlockLayout).
+* A block is allocated once, at its full size, and is never reallocated, so references to elements stay valid while the list grows at the end.
+* \tparam allocator_type The type of allocator to use in the BinaryVectorList container.
+* \tparam value_type The type of elements in the BinaryVectorList container.
+*/
+template<typename value_type, typename allocator_type = std::allocator<value_type> >
+class BinaryVectorList
+{
+public:
+	//Typedefs
+
+	/**
+	* A reference to value_type
+	*/
+	typedef value_type& reference;
+
+	/**
+	* A const reference to value_type
+	*/
+	typedef const value_type& const_reference;
+
+	/**
+	* A pointer to value_type given by allocator (usually value_type*)
+	*/
+	typedef typename std::allocator_traits<allocator_type>::pointer pointer;
+
+	/**
+	* A const pointer to value_type given by allocator (usually const value_type*)
+	*/
+	typedef typename std::allocator_traits<allocator_type>::const_pointer const_pointer;
+
+	/**
+	* An iterator type that can be used to iterate through the elements of a BinaryVectorList.
+	*/
+	typedef bvl::BinaryVectorListIterator<BinaryVectorList, value_type> iterator;
+
+	/**
+	* An iterator type that can be used to iterate through the elements of a BinaryVectorList, but not change the elements.
+	*/
+	typedef bvl::BinaryVectorListIterator<const BinaryVectorList, const value_type> const_iterator;
+
+	/**
+	* An iterator type that can be used to iterate through the elements of a BinaryVectorList in reverse order.
+	*/
+	typedef std::reverse_iterator<iterator> reverse_iterator;
+
+	/**
+	* An iterator type that can be used to iterate through the elements of a BinaryVectorList in reverse order, but not change the elements.
+	*/
+	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+	/**
+	* A long lived position that survives push_back and push_front (see bvl::BinaryVectorListCursor).
+	*/
+	typedef bvl::BinaryVectorListCursor<BinaryVectorList, value_type> cursor;
+
+	/**
+	* A long lived position that can not change the elements.
+	*/
+	typedef bvl::BinaryVectorListCursor<const BinaryVectorList, const value_type> const_cursor;
+
+	/**
+	* The blocks as a range of contiguous ranges (see chunks()).
+	*/
+	typedef bvl::BinaryVectorListChunks<BinaryVectorList, value_type> chunk_range;
+
+	/**
+	* The blocks as a range of contiguous ranges of const elements.
+	*/
+	typedef bvl::BinaryVectorListChunks<const BinaryVectorList, const value_type> const_chunk_range;
+
+	/**
+	* A signed integer type, usually ptrdiff_t.
+	*/
+	typedef typename std::allocator_traits<allocator_type>::difference_type difference_type;
+
+	/**
+	* An unsigned integer type that can represent any non-negative value of difference_type, usually size_t.
+	*/
+	typedef typename std::allocator_traits<allocator_type>::size_type size_type;
+
+	/**
+	* The block size progression used by this container. Block 0 holds 16 elements.
+	*/
+	typedef bvl::detail::BlockLayout<4> layout;
+
+	/**
+	* Copying a list of trivially copyable elements uses one more thread for every parallel_copy_bytes bytes, up to the number of hardware threads.
+	* 16MB copies in a few milliseconds, long enough to be worth starting a thread for.
+	*/
+	static const std::size_t parallel_copy_bytes = std::size_t(16) << 20;
+
+	//Constructors
+
+	/**
+	* \brief Empty Container Constructor
+	* Constructs an empty container with no elements.
+	* \param[in] alloc Allocator to use for the BinaryVectorList.
+	*/
+	BVL_CONSTEXPR20 BinaryVectorList(const allocator_type& alloc = allocator_type())
+		: m_apBlocks(), m_uBlocks(0), m_uSize(0), m_alloc(alloc)
+	{
+	}
+
+	/**
+	* \brief Fill Constructor
+	* Constructs a container with n elements. Each element is a copy of val.
+	* \param[in] n		Number of elements to create in the BinaryVectorList container.
+	* \param[in] val	The value to copy for the elements of the BinaryVectorList.
+	* \param[in] alloc	Allocator to use for the BinaryVectorList.
+	*/
+	BVL_CONSTEXPR20 BinaryVectorList(size_type n, const value_type& val = value_type(), const allocator_type& alloc = allocator_type())
+		: m_apBlocks(), m_uBlocks(0), m_uSize(0), m_alloc(alloc)
+	{
+		assign(n, val);
+	}
+
+	/**
+	* \brief Range Constructor
+	* Constructs a container with as many elements as the range [first,last),
+	* with each element constructed from its corresponding element in that range, in the same order.
+	* \tparam InputIterator The iterator type to a container whose elements are to be copied to the BinaryVectorList
+	* \param[in] first	Iterator to the first element in the container whose elements are to be copied into the BinaryVectorList.
+	* \param[in] last	Iterator to the last element in the container whose elements are to copied into the BinaryVectorList. NOTE: The last element is not copied into the BinaryVectorList.
+	* \param[in] alloc	Allocator to use for the BinaryVectorList.
+	*/
+	template<typename InputIterator, typename = typename std::iterator_traits<InputIterator>::iterator_category>
+	BVL_CONSTEXPR20 BinaryVectorList(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type())
+		: m_apBlocks(), m_uBlocks(0), m_uSize(0), m_alloc(alloc)
+	{
+		assign(first, last);
+	}
+
+	/**
+	* \brief Copy Constructor
+	* Constructs a container with a copy of each of the elements in bvl, in the same order.
+	* \param[in] bvl	BinaryVectorList to copy elements from.
+	* \param[in] alloc	Allocator to use for the BinaryVectorList.
+	*/
+	BVL_CONSTEXPR20 BinaryVectorList(const BinaryVectorList& bvl, const allocator_type& alloc = allocator_type())
+		: m_apBlocks(), m_uBlocks(0), m_uSize(0), m_alloc(alloc)
+	{
+		m_uContiguousBlocks = bvl.m_uContiguousBlocks;
+		copy_elements(bvl);
+	}
+
+	/**
+	* \brief Move Constructor
+	* Constructs a container that acquires the elements of bvl.
+	* If alloc is specified and is different from bvl's allocator, the elements are moved.
+	* Otherwise, no elements are constructed (their ownership is directly transferred).
+	* bvl is left in an unspecified but valid state.
+	* \param[in] bvl	BinaryVectorList to acquire elements from.
+	* \param[in] alloc	Allocator to use for the BinaryVectorList.
+	*/
+	BVL_CONSTEXPR20 BinaryVectorList(BinaryVectorList&& bvl, const allocator_type& alloc = allocator_type())
+		: m_apBlocks(), m_uBlocks(0), m_uSize(0), m_alloc(alloc)
+	{
+		if (m_alloc == bvl.m_alloc)
+		{
+			swap_blocks(bvl);
+			bvl.invalidate();
+		}
+		else
+		{
+			reserve(bvl.size());
+			assign(std::make_move_iterator(bvl.begin()), std::make_move_iterator(bvl.end()));
+			bvl.clear();
+		}
+	}
+
+	/**
+	* \brief Initializer List Constructor
+	* Constructs a container with a copy of each of the elements in il, in the same order.
+	* \param[in] il		Initializer List to copy elements from.
+	* \param[in] alloc	Allocator to use for the BinaryVectorList.
+	*/
+	BVL_CONSTEXPR20 BinaryVectorList(std::initializer_list<value_type> il, const allocator_type& alloc = allocator_type())
+		: m_apBlocks(), m_uBlocks(0), m_uSize(0), m_alloc(alloc)
+	{
+		assign(il.begin(), il.end());
+	}
+
+	//Destructor
+
+	/**
+	* \brief Destructor
+	* Deallocates all of the memory used by the BinaryVectorList
+	*/
+	BVL_CONSTEXPR20 ~BinaryVectorList()
+	{
+		clear();
+		release_blocks(0);
+	}
+
+	//Assignment Operators
+
+	/**
+	* \brief Copy Assignment
+	* Copies all the elements from bvl into the container (with bvl preserving its contents)
+	* \param[in] bvl BinaryVectorList to copy elements from.
+	* \return Reference to this (BinaryVectorList). This allows for function chaining.
+	*/
+	BVL_CONSTEXPR20 BinaryVectorList& operator= (const BinaryVectorList& bvl)
+	{
+		if (this != &bvl)
+		{
+			clear();
+			m_uContiguousBlocks = bvl.m_uContiguousBlocks;
+			copy_elements(bvl);
+		}
+		return *this;
+	}
+
+	/**
+	* \brief Move Assignment
+	* Moves the elements of bvl into the container (bvl is left in an unspecified but valid state)
+	* \param[in] bvl BinaryVectorList to copy elements from.
+	* \return Reference to this (BinaryVectorList). This allows for function chaining.
+	*/
+	BVL_CONSTEXPR20 BinaryVectorList& operator= (BinaryVectorList&& bvl)
+	{
+		if (this != &bvl)
+		{
+			clear();
+			swap(bvl);
+		}
+		return *this;
+	}
+
+	/**
+	* \brief Initializer List Assignment
+	* Copies the elements of il into the container.
+	* \param[in] il Initializer List to copy elements from.
+	* \return Reference to this (BinaryVectorList). This allows for function chaining.
+	*/
+	BVL_CONSTEXPR20 BinaryVectorList& operator= (std::initializer_list<value_type> il)
+	{
+		assign(il.begin(), il.end());
+		return *this;
+	}
+
+	//Iterators
+
+	/**
+	* \brief Return iterator to beginning
+	* Returns an iterator pointing to the first element in the BinaryVectorList.
+	* \return An iterator pointing to the first element of the BinaryVectorList
+	*/
+	BVL_CONSTEXPR20 iterator begin() noexcept
+	{
+		return iterator(this, 0);
+	}
+
+	/**
+	* \brief Return const iterator to beginning
+	* Returns a const_iterator pointing to the first element in the BinaryVectorList.
+	* \return A const_iterator pointing to the first element of the BinaryVectorList
+	*/
+	BVL_CONSTEXPR20 const_iterator begin() const noexcept
+	{
+		return const_iterator(this, 0);
+	}
+
+	/**
+	* \brief Return iterator to end
+	* Returns an iterator pointing to the past-the-end element in the BinaryVectorList.
+	* \return An iterator pointing to the past-the-end element of the BinaryVectorList
+	*/
+	BVL_CONSTEXPR20 iterator end() noexcept
+	{
+		return iterator(this, m_uSize);
+	}
+
+	/**
+	* \brief Return const iterator to end
+	* Returns a const_iterator pointing to the past-the-end element in the BinaryVectorList.
+	* \return A const_iterator pointing to the past-the-end element of the BinaryVectorList
+	*/
+	BVL_CONSTEXPR20 const_iterator end() const noexcept
+	{
+		return const_iterator(this, m_uSize);
+	}
+
+	/**
+	* \brief Return reverse iterator to the reverse beginning
+	* Returns a reverse_iterator pointing to the last element in the BinaryVectorList.
+	* \return A reverse_iterator pointing to the last element of the BinaryVectorList
+	*/
+	BVL_CONSTEXPR20 reverse_iterator rbegin() noexcept
+	{
+		return reverse_iterator(end());
+	}
+
+	/**
+	* \brief Return const reverse iterator to the reverse beginning
+	* Returns a const_reverse_iterator pointing to the last element in the BinaryVectorList.
+	* \return A const_reverse_iterator pointing to the last element of the BinaryVectorList
+	*/
+	BVL_CONSTEXPR20 const_reverse_iterator rbegin() const noexcept
+	{
+		return const_reverse_iterator(end());
+	}
+
+	/**
+	* \brief Return reverse iterator to the reverse end
+	* Returns a reverse_iterator pointing to the theoretical element preceding the first element in the BinaryVectorList.
+	* \return A reverse_iterator pointing to the theoretical element preceding the first element of the BinaryVectorList
+	*/
+	BVL_CONSTEXPR20 reverse_iterator rend() noexcept
+	{
+		return reverse_iterator(begin());
+	}
+
+	/**
+	* \brief Return const reverse iterator to the reverse end
+	* Returns a const_reverse_iterator pointing to the theoretical element preceding the first element in the BinaryVectorList.
+	* \return A const_reverse_iterator pointing to the theoretical element preceding the first element of the BinaryVectorList
+	*/
+	BVL_CONSTEXPR20 const_reverse_iterator rend() const noexcept
+	{
+		return const_reverse_iterator(begin());
+	}
+
+	/**
+	* \brief Return const_iterator to beginning
+	* Returns a const_iterator pointing to the first element in the BinaryVectorList.
+	* \return A const_iterator pointing to the first element of the BinaryVectorList
+	*/
+	BVL_CONSTEXPR20 const_iterator cbegin() const noexcept
+	{
+		return begin();
+	}
+
+	/**
+	* \brief Return const_iterator to end
+	* Returns a const_iterator pointing to the past-the-end element in the BinaryVectorList.
+	* \return A const_iterator pointing to the past-the-end element of the BinaryVectorList
+	*/
+	BVL_CONSTEXPR20 const_iterator cend() const noexcept
+	{
+		return end();
+	}
+
+	/**
+	* \brief Return const_reverse_iterator to the reverse beginning
+	* Returns a const_reverse_iterator pointing to the last element in the BinaryVectorList.
+	* \return A const_reverse_iterator pointing to the last element of the BinaryVectorList
+	*/
+	BVL_CONSTEXPR20 const_reverse_iterator crbegin() const noexcept
+	{
+		return rbegin();
+	}
+
+	/**
+	* \brief Return const_reverse_iterator to the reverse end
+	* Returns a const_reverse_iterator pointing to the theoretical element preceding the first element in the BinaryVectorList.
+	* \return A const_reverse_iterator pointing to the theoretical element preceding the first element of the BinaryVectorList
+	*/
+	BVL_CONSTEXPR20 const_reverse_iterator crend() const noexcept
+	{
+		return rend();
+	}
+
+	/**
+	* \brief Return a cursor at position n
+	* Unlike an iterator, the cursor stays on its element through push_back, push_front and pop_front of other elements.
+	* n may be at or past the end, the cursor then reads the elements appended there.
+	* \param[in] n	Position of the cursor
+	* \return A cursor at position n
+	*/
+	BVL_CONSTEXPR20 cursor cursor_at(size_type n) noexcept
+	{
+		return cursor(this, n);
+	}
+
+	/**
+	* \brief Return a const_cursor at position n
+	* \param[in] n	Position of the cursor
+	* \return A const_cursor at position n
+	*/
+	BVL_CONSTEXPR20 const_cursor cursor_at(size_type n) const noexcept
+	{
+		return const_cursor(this, n);
+	}
+
+	/**
+	* \brief Return the elements as a range of contiguous chunks
+	* Chunk k is block k, except that the last chunk ends at size(). Each chunk iterates with plain pointers,
+	* so nesting a loop over a chunk inside a loop over chunks() (or std::views::join(chunks())) lets the compiler vectorize the inner loop.
+	* \return A range of BinaryVectorListChunk, one per block in use
+	*/
+	BVL_CONSTEXPR20 chunk_range chunks() noexcept
+	{
+		return chunk_range(this);
+	}
+
+	/**
+	* \brief Return the elements as a range of contiguous chunks of const elements
+	* \return A range of BinaryVectorListChunk, one per block in use
+	*/
+	BVL_CONSTEXPR20 const_chunk_range chunks() const noexcept
+	{
+		return const_chunk_range(this);
+	}
+
+	//Capacity
+
+	/**
+	* \brief Return size of BinaryVectorList
+	* Returns the number of elements in the BinaryVectorList.
+	* \return The number of elements in the BinaryVectorList.
+	*/
+	BVL_CONSTEXPR20 size_type size() const noexcept
+	{
+		return m_uSize;
+	}
+
+	/**
+	* \brief Return maximum size of BinaryVectorList
+	* Returns the maximum number of elements the BinaryVectorList can hold.
+	* \return The maximum number of elements the BinaryVectorList can hold.
+	*/
+	BVL_CONSTEXPR20 size_type max_size() const noexcept
+	{
+		//the last position has to leave room for the first block size to be added in layout::block_of
+		const std::uint64_t uLayoutMax = std::numeric_limits<std::uint64_t>::max() - layout::first_block_size;
+		const std::uint64_t uAllocMax = std::allocator_traits<allocator_type>::max_size(m_alloc);
+		return static_cast<size_type>(std::min(uLayoutMax, uAllocMax));
+	}
+
+	/**
+	* \brief Change size
+	* Resizes the BinaryVectorList so that it contains n elements.
+	* \param[in] n		Number of elements to resize the BinaryVectorList to.
+	* \param[in] val	Value to fill added elements with if n is greater than the current BinaryVectorList size.
+	*/
+	BVL_CONSTEXPR20 void resize(size_type n, const value_type val = value_type())
+	{
+		while (m_uSize > n)
+		{
+			pop_back();
+		}
+		reserve(n);
+		while (m_uSize < n)
+		{
+			push_back(val);
+		}
+	}
+
+	/**
+	* \brief Return size of currently allocated storage capacity
+	* Returns the size of the storage space currently allocated for the BinaryVectorElement, expressed in terms of value_type elements.
+	* \return The size of the storage space currently allocated for the BinaryVectorElement, expressed in terms of value_type elements.
+	*/
+	BVL_CONSTEXPR20 size_type capacity() const noexcept
+	{
+		return static_cast<size_type>(layout::block_start(m_uBlocks));
+	}
+
+	/**
+	* \brief Test whether the BinaryVectorList is empty
+	* Returns whether the BinaryVectorList's size is 0.
+	* \return Whether the size is 0
+	*/
+	BVL_CONSTEXPR20 bool empty() const noexcept
+	{
+		return m_uSize == 0;
+	}
+
+	/**
+	* \brief Request a change in capacity
+	* Requests that the BinaryVectorList capacity be enough to contain at least n elements.
+	* No element is moved, the missing blocks are allocated at the end of the list.
+	* \param[in] n Minimum number of elements the BinaryVectorList should contain
+	*/
+	BVL_CONSTEXPR20 void reserve(size_type n)
+	{
+		if (n > max_size())
+		{
+			throw std::length_error("BinaryVectorList::reserve");
+		}
+		if (capacity() < n && grows_array())
+		{
+			move_into_array(std::min(layout::block_of(n - 1) + 1, m_uContiguousBlocks));
+		}
+		while (capacity() < n)
+		{
+			add_block();
+		}
+	}
+
+	/**
+	* \brief Request a down-size of capacity
+	* Requests the BinaryVectorList shrink to a capacity that matches it current size
+	* Only blocks past the last element are released, so the capacity can still be up to twice the size.
+	*/
+	BVL_CONSTEXPR20 void shrink_to_fit()
+	{
+		release_blocks(static_cast<unsigned>(chunk_count()));
+	}
+
+	/**
+	* \brief Rewrite the list as one contiguous array
+	* Moves every element into a single allocation that holds the blocks in use back to back. Positions map to blocks as before,
+	* so nothing else changes, but a scan now reads one array and data() returns it. Spare blocks are released.
+	* Blocks added by later growth are separate allocations again, and the list stops being contiguous once it uses one.
+	* With AlignedAllocator the blocks are not packed, block k of the array could not start on an alignment boundary,
+	* so compact() only releases the spare blocks.
+	* Invalidates all iterators, references and pointers. If moving an element throws, the list is unchanged.
+	*/
+	void compact()
+	{
+		unsigned uBlocks = static_cast<unsigned>(chunk_count());
+		if (uBlocks <= 1 || uBlocks <= m_uCompactBlocks || bvl::detail::aligns_blocks<allocator_type>::value)
+		{
+			shrink_to_fit();
+			return;
+		}
+		move_into_array(uBlocks);
+	}
+
+	/**
+	* \brief Whether every element is in one array, which data() returns
+	* \return true if the elements in use are in 1 block or in the array made by compact()
+	*/
+	BVL_CONSTEXPR20 bool is_contiguous() const noexcept
+	{
+		return chunk_count() <= 1 || chunk_count() <= m_uCompactBlocks;
+	}
+
+	/**
+	* \brief Keep the elements in one array until the list needs room for more than n
+	* Up to that capacity, growing moves the elements to a larger array, the way std::vector grows, and data() stays available.
+	* Past it the array is kept, as the first blocks, and the list grows by separate doubling blocks that never move,
+	* so a large list never pays for copying everything again. n is rounded up to the end of a block.
+	* While the list grows within the array, push_back invalidates iterators, references and pointers, as it does for std::vector.
+	* The limit goes with the contents when the list is copied, moved or swapped.
+	* With AlignedAllocator the limit stays 0: the array packs blocks back to back, and they would lose their alignment.
+	* \param[in] n Number of elements to keep contiguous, 0 (the default) to always grow by blocks.
+	*/
+	void set_contiguous_limit(size_type n)
+	{
+		if (n > max_size())
+		{
+			throw std::length_error("BinaryVectorList::set_contiguous_limit");
+		}
+		m_uContiguousBlocks = n && !bvl::detail::aligns_blocks<allocator_type>::value ? layout::block_of(n - 1) + 1 : 0;
+	}
+
+	/**
+	* \brief Return the capacity up to which the list grows as one array
+	* \return The limit given to set_contiguous_limit() rounded up to a block, 0 if the list always grows by blocks.
+	*/
+	BVL_CONSTEXPR20 size_type contiguous_limit() const noexcept
+	{
+		return static_cast<size_type>(layout::block_start(m_uContiguousBlocks));
+	}
+
+	//Element Access
+
+	/**
+	* \brief Access element
+	* Returns a reference to the element at position n in the BinaryVectorList.
+	* \param[in] n Position of the desired element.
+	* \return A reference to the element at position n
+	*/
+	BVL_CONSTEXPR20 reference operator[] (size_type n)
+	{
+		BVL_HARDENED_CHECK(n < m_uSize, "operator[] past the end");
+		unsigned k = layout::block_of(n);
+		return m_apBlocks[k][static_cast<size_type>(layout::offset_of(n, k))];
+	}
+
+	/**
+	* \brief Access element
+	* Returns a const_reference to the element at position n in the BinaryVectorList.
+	* \param[in] n position of the desired element.
+	* \return A const_reference to the element at position n
+	*/
+	BVL_CONSTEXPR20 const_reference operator[] (size_type n) const
+	{
+		BVL_HARDENED_CHECK(n < m_uSize, "operator[] past the end");
+		unsigned k = layout::block_of(n);
+		return m_apBlocks[k][static_cast<size_type>(layout::offset_of(n, k))];
+	}
+
+	/**
+	* \brief Access element
+	* Returns a reference to the element at position n in the BinaryVectorList.
+	* \param[in] n Position of the desired element.
+	* \return A reference to the element at position n
+	* \throw std::out_of_range if n is not less than size()
+	*/
+	BVL_CONSTEXPR20 reference at(size_type n)
+	{
+		if (n >= m_uSize)
+		{
+			throw std::out_of_range("BinaryVectorList::at");
+		}
+		return (*this)[n];
+	}
+
+	/**
+	* \brief Access element
+	* Returns a const_reference to the element at position n in the BinaryVectorList.
+	* \param[in] n Position of the desired element.
+	* \return A const_reference to the element at position n
+	* \throw std::out_of_range if n is not less than size()
+	*/
+	BVL_CONSTEXPR20 const_reference at(size_type n) const
+	{
+		if (n >= m_uSize)
+		{
+			throw std::out_of_range("BinaryVectorList::at");
+		}
+		return (*this)[n];
+	}
+
+	/**
+	* \brief Access first element
+	* Returns a reference to the first element in the BinaryVectorList.
+	* \return A reference to the first element in the BinaryVectorList.
+	*/
+	BVL_CONSTEXPR20 reference front()
+	{
+		BVL_HARDENED_CHECK(m_uSize != 0, "front() of an empty list");
+		return m_apBlocks[0][0];
+	}
+
+	/**
+	* \brief Access first element
+	* Returns a const_reference to the first element in the BinaryVectorList.
+	* \return A const_reference to the first element in the BinaryVectorList.
+	*/
+	BVL_CONSTEXPR20 const_reference front() const
+	{
+		BVL_HARDENED_CHECK(m_uSize != 0, "front() of an empty list");
+		return m_apBlocks[0][0];
+	}
+
+	/**
+	* \brief Access last element
+	* Returns a reference to the last element in the BinaryVectorList.
+	* \return A reference to the last element in the BinaryVectorList.
+	*/
+	BVL_CONSTEXPR20 reference back()
+	{
+		return (*this)[m_uSize - 1];
+	}
+
+	/**
+	* \brief Access last element
+	* Returns a const_reference to the last element in the BinaryVectorList.
+	* \return A const_reference to the last element in the BinaryVectorList.
+	*/
+	BVL_CONSTEXPR20 const_reference back() const
+	{
+		return (*this)[m_uSize - 1];
+	}
+
+	/**
+	* \brief Access the elements as an array
+	* Only possible while is_contiguous(), see compact().
+	* \return A pointer to the first element if the elements are contiguous, otherwise nullptr.
+	*/
+	BVL_CONSTEXPR20 pointer data() noexcept
+	{
+		return is_contiguous() && m_uBlocks ? m_apBlocks[0] : pointer();
+	}
+
+	/**
+	* \brief Access the elements as a const array
+	* Only possible while is_contiguous(), see compact().
+	* \return A const pointer to the first element if the elements are contiguous, otherwise nullptr.
+	*/
+	BVL_CONSTEXPR20 const_pointer data() const noexcept
+	{
+		return is_contiguous() && m_uBlocks ? const_pointer(m_apBlocks[0]) : const_pointer();
+	}
+
+	//Batch Access
+
+	/**
+	* \brief Gather elements
+	* Copies the element at each position in [first, last) to out, in order. Positions are not bounds checked.
+	* Random positions in a large list each miss the cache, so the positions are translated to blocks gather_batch at a time,
+	* and each element is prefetched gather_prefetch_distance elements before it is read, so that the misses overlap instead of queueing.
+	* The positions are not sorted by block: with random positions nearly every one is in the largest blocks,
+	* and sorting would cost more than the misses it saves.
+	* \tparam InputIterator	Iterator to positions (convertible to size_type).
+	* \tparam OutputIterator	Iterator that value_type can be assigned through.
+	* \param[in] first	Iterator to the first position to read.
+	* \param[in] last	Iterator past the last position to read.
+	* \param[out] out	Where to copy the elements to.
+	* \return An iterator past the last element written to out.
+	*/
+	template<typename InputIterator, typename OutputIterator>
+	OutputIterator gather(InputIterator first, InputIterator last, OutputIterator out) const
+	{
+		unsigned auBlocks[gather_batch];
+		std::uint64_t auOffsets[gather_batch];
+		while (std::size_t uCount = translate_batch(first, last, auBlocks, auOffsets))
+		{
+			for (std::size_t i = 0; i < uCount; ++i, ++out)
+			{
+				if (i + gather_prefetch_distance < uCount)
+				{
+					bvl::detail::prefetch(std::addressof(m_apBlocks[auBlocks[i + gather_prefetch_distance]][auOffsets[i + gather_prefetch_distance]]));
+				}
+				*out = m_apBlocks[auBlocks[i]][auOffsets[i]];
+			}
+		}
+		return out;
+	}
+
+	/**
+	* \brief Scatter elements
+	* Assigns each value in the range starting at values to the element at the matching position in [first, last).
+	* Positions are not bounds checked. Positions are translated and prefetched the same way as in gather(),
+	* and the writes are applied in order, so the last write to a repeated position wins.
+	* \tparam InputIterator	Iterator to positions (convertible to size_type).
+	* \tparam ValueIterator	Iterator to values assignable to value_type.
+	* \param[in] first	Iterator to the first position to write.
+	* \param[in] last	Iterator past the last position to write.
+	* \param[in] values	Iterator to the value for *first.
+	*/
+	template<typename InputIterator, typename ValueIterator>
+	void scatter(InputIterator first, InputIterator last, ValueIterator values)
+	{
+		scatter_apply(first, last, values, [](value_type& dst, const value_type& val) { dst = val; });
+	}
+
+	/**
+	* \brief Scatter elements in parallel
+	* Like scatter(), but splits the list into uThreads equal ranges of positions and writes each range on its own thread.
+	* Every thread reads all of the positions and applies the ones in its range, in order, so nothing is copied
+	* and a repeated position still ends up with its last value. The positions and values are read uThreads times,
+	* so they must be forward iterators; with single pass iterators the writes are applied on the calling thread.
+	* \param[in] uThreads Number of threads to use.
+	*/
+	template<typename InputIterator, typename ValueIterator>
+	void scatter(InputIterator first, InputIterator last, ValueIterator values, unsigned uThreads)
+	{
+		scatter_parallel(first, last, values, uThreads, [](value_type& dst, const value_type& val) { dst = val; });
+	}
+
+	/**
+	* \brief Scatter add
+	* Adds each value in the range starting at values to the element at the matching position in [first, last).
+	* Works like scatter(), and a repeated position receives every one of its values. Only for arithmetic types.
+	* \param[in] first	Iterator to the first position to add to.
+	* \param[in] last	Iterator past the last position to add to.
+	* \param[in] values	Iterator to the value for *first.
+	*/
+	template<typename InputIterator, typename ValueIterator>
+	void scatter_add(InputIterator first, InputIterator last, ValueIterator values)
+	{
+		static_assert(std::is_arithmetic<value_type>::value, "scatter_add needs an arithmetic value_type");
+		scatter_apply(first, last, values, [](value_type& dst, const value_type& val) { dst += val; });
+	}
+
+	/**
+	* \brief Scatter add in parallel
+	* Like scatter_add(), with the writes split over uThreads threads by range of positions, so no two threads touch the same element.
+	* \param[in] uThreads Number of threads to use.
+	*/
+	template<typename InputIterator, typename ValueIterator>
+	void scatter_add(InputIterator first, InputIterator last, ValueIterator values, unsigned uThreads)
+	{
+		static_assert(std::is_arithmetic<value_type>::value, "scatter_add needs an arithmetic value_type");
+		scatter_parallel(first, last, values, uThreads, [](value_type& dst, const value_type& val) { dst += val; });
+	}
+
+	/**
+	* \brief Hints the element at position n into the cache. Does nothing if n is past the capacity.
+	*/
+	BVL_CONSTEXPR20 void prefetch(size_type n) const noexcept
+	{
+		const value_type* p = locate(n);
+		if (p)
+		{
+			bvl::detail::prefetch(p);
+		}
+	}
+
+	/**
+	* How many positions gather() and scatter() translate to blocks and offsets at once
+	*/
+	static const std::size_t gather_batch = 256;
+
+	/**
+	* How far ahead of the element being accessed gather() and scatter() prefetch.
+	* Enough misses to keep the memory system busy without the prefetched lines being evicted before they are used.
+	*/
+	static const std::size_t gather_prefetch_distance = 16;
+
+	//Modifiers
+
+	/**
+	* \brief Assign BinaryVectorList content from another container
+	* Assigns new content to the BinaryVectorList, replacing its current contents with copies from the elements in [first,last), and modifying it's size accordingly.
+	* \tparam InputIterator The iterator type to a container whose elements are to be copied to the BinaryVectorList
+	* \param[in] first	InputIterator to the initial position in the container to be copied from
+	* \param[in] last	InputIterator to the final position in the container to be copied from
+	*/
+	template <typename InputIterator>
+	BVL_CONSTEXPR20 void assign(InputIterator first, InputIterator last)
+	{
+		clear();
+		for (; first != last; ++first)
+		{
+			emplace_back(*first);
+		}
+	}
+
+	/**
+	* \brief Assign BinaryVectorList content with copies of a value
+	* Assigns new content to the BinaryVectorList, replacing its current contents with n copies of val, and modifying it's size accordingly.
+	* \param[in] n		New size for the BinaryVectorList
+	* \param[in] val	Value to fill the container with
+	*/
+	BVL_CONSTEXPR20 void assign(size_type n, const value_type& val)
+	{
+		//val may be one of our own elements
+		value_type tmp(val);
+		clear();
+		reserve(n);
+		for (size_type i = 0; i < n; ++i)
+		{
+			push_back(tmp);
+		}
+	}
+
+	/**
+	* \brief Assign BinaryVectorList content from an initializer_list
+	* Assigns new content to the BinaryVectorList, replacing its current contents with the values from the initializer_list, and modifying it's size accordingly.
+	* \param[in] il Initializer List to copy elements from.
+	*/
+	BVL_CONSTEXPR20 void assign(std::initializer_list<value_type> il)
+	{
+		assign(il.begin(), il.end());
+	}
+
+	/**
+	* \brief Add an element at the end of the BinaryVectorList
+	* Adds a new element at the end of the BinaryVectorList. The content of val is copied to the new element
+	* \param[in] val Value to be copied to the new element
+	*/
+	BVL_CONSTEXPR20 void push_back(const value_type& val)
+	{
+		emplace_back(val);
+	}
+
+	/**
+	* \brief Add an element at the end of the BinaryVectorList
+	* Adds a new element at the end of the BinaryVectorList. The content of val is moved to the new element
+	* \param[in] val Value to be moved to the new element
+	*/
+	BVL_CONSTEXPR20 void push_back(value_type&& val)
+	{
+		emplace_back(std::move(val));
+	}
+
+	/**
+	* \brief Add an element at the beginning of the BinaryVectorList
+	* Adds a new element at the beginning of the BinaryVectorList. The content of val is copied to the new element
+	* \param[in] val Value to be copied to the new element
+	*/
+	BVL_CONSTEXPR20 void push_front(const value_type& val)
+	{
+		insert(cbegin(), val);
+		++m_uFrontShift;
+	}
+
+	/**
+	* \brief Add an element at the beginning of the BinaryVectorList
+	* Adds a new element at the beginning of the BinaryVectorList. The content of val is moved to the new element
+	* \param[in] val Value to be moved to the new element
+	*/
+	BVL_CONSTEXPR20 void push_front(value_type&& val)
+	{
+		insert(cbegin(), std::move(val));
+		++m_uFrontShift;
+	}
 
 	/**
-	* A reference to value_type
+	* \brief Deletes the last element of the BinaryVectorList
+	* Removes the last element in the BinaryVectorList, effectively reducing the container size by 1.
 	*/
-	typedef value_type& reference;
+	BVL_CONSTEXPR20 void pop_back()
+	{
+		BVL_HARDENED_CHECK(m_uSize != 0, "pop_back() of an empty list");
+		--m_uSize;
+		std::allocator_traits<allocator_type>::destroy(m_alloc, locate(m_uSize));
+		invalidate();
+	}
 
 	/**
-	* A const reference to value_type
+	* \brief Deletes the first element of the BinaryVectorList
+	* Removes the first element in the BinaryVectorList, effectively reducing the container size by 1.
 	*/
-	typedef const reference const_reference;
+	BVL_CONSTEXPR20 void pop_front()
+	{
+		erase(cbegin());
+		--m_uFrontShift;
+	}
 
 	/**
-	* A pointer to value_type given by allocator (usually value_type*)
+	* \brief Removes the first n elements and moves them to out, in order
+	* The elements are moved a block at a time with std::move on plain pointers, then the rest of the list moves down by n in one pass.
+	* \tparam OutputIterator	Iterator to write the elements to, for example a pointer into a span or a back_insert_iterator
+	* \param[in] n		Number of elements to remove, at most size()
+	* \param[in] out	Where to move the first element
+	* \return out past the last moved element
 	*/
-	typedef std::allocator_traits<allocator_type>::pointer pointer;
+	template<typename OutputIterator>
+	BVL_CONSTEXPR20 OutputIterator pop_front_n(size_type n, OutputIterator out)
+	{
+		BVL_HARDENED_CHECK(n <= m_uSize, "pop_front_n() past the end");
+		out = move_range(0, n, out);
+		move_range(n, m_uSize, begin());
+		destroy_back(n);
+		m_uFrontShift -= n;
+		return out;
+	}
 
 	/**
-	* A const pointer to value_type given by allocator (usually const value_type*)
+	* \brief Removes the first n elements and appends them to out
+	* If out is empty and n is at least half the list, the blocks holding the first n elements are handed to out as they are,
+	* and only the elements after them move, into the spare blocks of out. Otherwise the elements are moved one block at a time.
+	* \param[in] n		Number of elements to remove, at most size()
+	* \param[in] out	List to append the elements to
 	*/
-	typedef std::allocator_traits<allocator_type>::const_pointer const_pointer;
+	BVL_CONSTEXPR20 void pop_front_n(size_type n, BinaryVectorList& out)
+	{
+		BVL_HARDENED_CHECK(&out != this, "pop_front_n() into its own list");
+		BVL_HARDENED_CHECK(n <= m_uSize, "pop_front_n() past the end");
+		size_type uKept = m_uSize - n;
+		if (out.empty() && n != 0 && n >= uKept && m_alloc == out.m_alloc && std::is_nothrow_move_constructible<value_type>::value)
+		{
+			out.reserve(uKept);
+			give_blocks(out);
+			out.move_append(n, out.m_uSize, *this);
+			out.destroy_back(uKept);
+		}
+		else
+		{
+			move_append(0, n, out);
+			move_range(n, m_uSize, begin());
+			destroy_back(n);
+		}
+		m_uFrontShift -= n;
+	}
 
-	template<typename iterator_type>
-	class BinaryVectorListIterator : public std::iterator<std::random_access_iterator_tag, iterator_type>
+	/**
+	* \brief Removes the last n elements and moves them to out, in order
+	* The elements are moved a block at a time with std::move on plain pointers.
+	* \tparam OutputIterator	Iterator to write the elements to, for example a pointer into a span or a back_insert_iterator
+	* \param[in] n		Number of elements to remove, at most size()
+	* \param[in] out	Where to move the first of the last n elements
+	* \return out past the last moved element
+	*/
+	template<typename OutputIterator>
+	BVL_CONSTEXPR20 OutputIterator pop_back_n(size_type n, OutputIterator out)
 	{
-	public:
-		BinaryVectorListIterator() {}
-		BinaryVectorListIterator(iterator_type rhs) : iter(rhs) {}
-		BinaryVectorListIterator(const BinaryVectorListIterator &rhs) : iter(rhs.iter) {}
-		/* inline Iterator& operator=(Type* rhs) {_ptr = rhs; return *this;} */
-		/* inline Iterator& operator=(const Iterator &rhs) {_ptr = rhs._ptr; return *this;} */
-		inline BinaryVectorListIterator& operator+=(difference_type rhs) { _ptr += rhs; return *this; }
-		inline BinaryVectorListIterator& operator-=(difference_type rhs) { _ptr -= rhs; return *this; }
-		inline Type& operator*() const { return *_ptr; }
-		inline Type* operator->() const { return _ptr; }
-		inline Type& operator[](difference_type rhs) const { return _ptr[rhs]; }
-
-		inline BinaryVectorListIterator& operator++() { ++_ptr; return *this; }
-		inline BinaryVectorListIterator& operator--() { --_ptr; return *this; }
-		inline BinaryVectorListIterator operator++(int) const { Iterator tmp(*this); ++_ptr; return tmp; }
-		inline BinaryVectorListIterator operator--(int) const { Iterator tmp(*this); --_ptr; return tmp; }
-		/* inline Iterator operator+(const Iterator& rhs) {return Iterator(_ptr+rhs.ptr);} */
-		inline difference_type operator-(const BinaryVectorListIterator& rhs) const { return Iterator(_ptr - rhs.ptr); }
-		inline BinaryVectorListIterator operator+(difference_type rhs) const { return Iterator(_ptr + rhs); }
-		inline BinaryVectorListIterator operator-(difference_type rhs) const { return Iterator(_ptr - rhs); }
-		friend inline BinaryVectorListIterator operator+(difference_type lhs, const BinaryVectorListIterator& rhs) { return Iterator(lhs + rhs._ptr); }
-		friend inline BinaryVectorListIterator operator-(difference_type lhs, const BinaryVectorListIterator& rhs) { return Iterator(lhs - rhs._ptr); }
-
-		inline bool operator==(const BinaryVectorListIterator& rhs) const { return _ptr == rhs._ptr; }
-		inline bool operator!=(const BinaryVectorListIterator& rhs) const { return _ptr != rhs._ptr; }
-		inline bool operator>(const BinaryVectorListIterator& rhs) const { return _ptr > rhs._ptr; }
-		inline bool operator<(const BinaryVectorListIterator& rhs) const { return _ptr < rhs._ptr; }
-		inline bool operator>=(const BinaryVectorListIterator& rhs) const { return _ptr >= rhs._ptr; }
-		inline bool operator<=(const BinaryVectorListIterator& rhs) const { return _ptr <= rhs._ptr; }
-	private:
-		iterator_type iter;
-	};
+		BVL_HARDENED_CHECK(n <= m_uSize, "pop_back_n() past the end");
+		out = move_range(m_uSize - n, m_uSize, out);
+		destroy_back(n);
+		return out;
+	}
 
 	/**
-	* An iterator type that can be used to iterate through the elements of a BinaryVectorList.
+	* \brief Removes the last n elements and appends them to out
+	* If n is the whole list and out is empty, the blocks are handed to out and no element moves.
+	* Otherwise the elements are moved one block at a time.
+	* \param[in] n		Number of elements to remove, at most size()
+	* \param[in] out	List to append the elements to
 	*/
-	//Not sure what type we need here yet. Probably std::vector::iterator, but until implementation is concluded we won't know.
-	typedef std::vector<value_type>::iterator iterator;
+	BVL_CONSTEXPR20 void pop_back_n(size_type n, BinaryVectorList& out)
+	{
+		BVL_HARDENED_CHECK(&out != this, "pop_back_n() into its own list");
+		BVL_HARDENED_CHECK(n <= m_uSize, "pop_back_n() past the end");
+		if (out.empty() && n != 0 && n == m_uSize && m_alloc == out.m_alloc)
+		{
+			give_blocks(out);
+			return;
+		}
+		move_append(m_uSize - n, m_uSize, out);
+		destroy_back(n);
+	}
 
 	/**
-	* An iterator type that can be used to iterate through the elements of a BinaryVectorList, but not change the elements. 
+	* \brief Insert a copy of 1 element
+	* The BinaryVectorList is extended by inserting a copy of val before the element at the specified position.
+	* \param[in] position	The position where the new elements are to be inserted
+	* \param[in] val		The value be copied
+	* \return An iterator that points to the newly inserted element
 	*/
-	// Not sure what type we need here yet.Probably std::vector::const_iterator, but until implementation is concluded we won't know.
-	typedef std::vector<value_type>::const_iterator const_iterator;
+	BVL_CONSTEXPR20 iterator insert(const_iterator position, const value_type& val)
+	{
+		return emplace(position, val);
+	}
 
 	/**
-	* An iterator type that can be used to iterate through the elements of a BinaryVectorList in reverse order.
+	* \brief Insert n copies of 1 element
+	* The BinaryVectorList is extended by inserting n copies of val before the element at the specified position.
+	* \param[in] position	The position where the new elements are to be inserted
+	* \param[in] n			The number of elements to insert
+	* \param[in] val		The value be copied
+	* \return An iterator that points to the first newly inserted element
 	*/
-	typedef std::reverse_iterator<iterator> reverse_iterator;
+	BVL_CONSTEXPR20 iterator insert(const_iterator position, size_type n, const value_type& val)
+	{
+		difference_type iIndex = position - cbegin();
+		size_type uOldSize = m_uSize;
+		//val may be one of our elements, and reserve moves them while the list grows as one array
+		value_type tmp(val);
+		reserve(m_uSize + n);
+		for (size_type i = 0; i < n; ++i)
+		{
+			push_back(tmp);
+		}
+		std::rotate(begin() + iIndex, begin() + uOldSize, end());
+		invalidate();
+		return begin() + iIndex;
+	}
 
 	/**
-	* An iterator type that can be used to iterate through the elements of a BinaryVectorList in reverse order, but not change the elements.
+	* \brief Insert elements from an InputIterator
+	* The BinaryVectorList is extended by inserting copies of elements from the range [first, last) before the element at the specified position.
+	* \tparam InputIterator The iterator type to a container whose elements are to be copied to the BinaryVectorList
+	* \param[in] position	The position where the new elements are to be inserted
+	* \param[in] first		InputIterator specifying the initial position in a container to copy from
+	* \param[in] last		InputIterator specifying the final position in a container to copy from
+	* \return An iterator that points to the first newly inserted element
 	*/
-	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+	template<typename InputIterator, typename = typename std::iterator_traits<InputIterator>::iterator_category>
+	BVL_CONSTEXPR20 iterator insert(const_iterator position, InputIterator first, InputIterator last)
+	{
+		difference_type iIndex = position - cbegin();
+		size_type uOldSize = m_uSize;
+		for (; first != last; ++first)
+		{
+			emplace_back(*first);
+		}
+		std::rotate(begin() + iIndex, begin() + uOldSize, end());
+		invalidate();
+		return begin() + iIndex;
+	}
 
 	/**
-	* A signed integer type, usually ptrdiff_t.
+	* \brief Insert a moved element
+	* The BinaryVectorList is extended by inserting val before the element at the specified position. val is moved from it's old container
+	* \param[in] position	The position where the new elements are to be inserted
+	* \param[in] val		The value be moved
+	* \return An iterator that points to the newly inserted element
 	*/
-	typedef std::iterator_traits<iterator>::difference_type difference_type;
+	BVL_CONSTEXPR20 iterator insert(const_iterator position, value_type&& val)
+	{
+		return emplace(position, std::move(val));
+	}
 
 	/**
-	* An unsigned integer type that can represent any non-negative value of difference_type, usually size_t.
+	* \brief Insert elements from an initializer_list
+	* The BinaryVectorList is extended by inserting copies of elements from the initializer_list before the element at the specified position.
+	* \param[in] position	The position where the new elements are to be inserted
+	* \param[in] il			Initializer_list to copy from
+	* \return An iterator that points to the newly inserted element
 	*/
-	typedef std::iterator_traits<iterator>::size_type size_type;
+	BVL_CONSTEXPR20 iterator insert(const_iterator position, std::initializer_list<value_type> il)
+	{
+		return insert(position, il.begin(), il.end());
+	}
 
-	//Constructors
+	/**
+	* \brief Erase an element
+	* Removes a single element from the binary
+	* \param[in] position The position of the element to be remove
+	* \return An iterator that points to the new location of the element that was after the erased element.
+	*/
+	BVL_CONSTEXPR20 iterator erase(const_iterator position)
+	{
+		return erase(position, position + 1);
+	}
 
 	/**
-	* \brief Empty Container Constructor
-	* Constructs an empty container with no elements.
-	* \param[in] alloc Allocator to use for the BinaryVectorList.
+	* \brief Erase a range of elements
+	* Removes the elements in the range [first,last)
+	* \param[in] first	The position of the first element to remove
+	* \param[in] last	The position after the last element to remove
+	* \return An iterator that points to the new location of the element that was after the last erased element.
 	*/
-	BinaryVectorList(const allocator_type& alloc = allocator_type())
+	BVL_CONSTEXPR20 iterator erase(const_iterator first, const_iterator last)
 	{
-		m_vTvector(alloc);
+		difference_type iFirst = first - cbegin();
+		difference_type iLast = last - cbegin();
+		std::move(begin() + iLast, end(), begin() + iFirst);
+		for (difference_type i = iFirst; i < iLast; ++i)
+		{
+			pop_back();
+		}
+		return begin() + iFirst;
 	}
 
 	/**
-	* \brief Fill Constructor
-	* Constructs a container with n elements. Each element is a copy of val.
-	* \param[in] n		Number of elements to create in the BinaryVectorList container.
-	* \param[in] val	The value to copy for the elements of the BinaryVectorList.
-	* \param[in] alloc	Allocator to use for the BinaryVectorList.
+	* \brief Swap BinaryVectorList content
+	* Exchanges the content of the BinaryVectorList by the content of another BinaryVectorList, bvl.
+	* \param[in] bvl The BinaryVectorList to swap contents with
 	*/
-	BinaryVectorList(size_type n, const value_type& val = value_type(), const allocator_type& alloc = allocator_type())
+	BVL_CONSTEXPR20 void swap(BinaryVectorList& bvl)
 	{
-		m_vTvector(n, val, alloc);
+		swap_blocks(bvl);
+		std::swap(m_alloc, bvl.m_alloc);
+		invalidate();
+		bvl.invalidate();
 	}
 
 	/**
-	* \brief Range Constructor
-	* Constructs a container with as many elements as the range [first,last),
-	* with each element constructed from its corresponding element in that range, in the same order.
-	* \tparam InputIterator The iterator type to a container whose elements are to be copied to the BinaryVectorList
-	* \param[in] first	Iterator to the first element in the container whose elements are to be copied into the BinaryVectorList.
-	* \param[in] last	Iterator to the last element in the container whose elements are to copied into the BinaryVectorList. NOTE: The last element is not copied into the BinaryVectorList.
-	* \param[in] alloc	Allocator to use for the BinaryVectorList.
+	* \brief Empty BinaryVectorList contents
+	* Removes all elements from the BinaryVectorList, leaving the container with a size of 0.
+	* The blocks stay allocated, like the capacity of std::vector.
 	*/
-	template<typename InputIterator>
-	BinaryVectorList(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type())
+	BVL_CONSTEXPR20 void clear() noexcept
 	{
-		m_vTvector(first, last, alloc);
+		for (unsigned k = 0; k < m_uBlocks && layout::block_start(k) < m_uSize; ++k)
+		{
+			size_type uCount = static_cast<size_type>(std::min<std::uint64_t>(layout::block_size(k), m_uSize - layout::block_start(k)));
+			for (size_type i = 0; i < uCount; ++i)
+			{
+				std::allocator_traits<allocator_type>::destroy(m_alloc, std::addressof(m_apBlocks[k][i]));
+			}
+		}
+		m_uSize = 0;
+		invalidate();
 	}
 
 	/**
-	* \brief Copy Constructor
-	* Constructs a container with a copy of each of the elements in bvl, in the same order.
-	* \param[in] bvl	BinaryVectorList to copy elements from.
-	* \param[in] alloc	Allocator to use for the BinaryVectorList.
+	* \brief Construct and insert an element
+	* The container is extended by inserting a new element constructed in place (using args as the arguments for its constructor) at position.
+	* \tparam Args The arguments to the constructor for the element being emplaced
+	* \param[in] position	The position to add the new element
+	* \param[in] args		The arguments to the constructor to build the new element
+	* \return An iterator that points to the new element
 	*/
-	BinaryVectorList(const BinaryVectorList& bvl, const allocator_type& alloc = allocator_type())
+	template<typename... Args>
+	BVL_CONSTEXPR20 iterator emplace(const_iterator position, Args&&... args)
 	{
-		m_vTvector(bvl.m_vTvector, alloc);
+		difference_type iIndex = position - cbegin();
+		emplace_back(std::forward<Args>(args)...);
+		std::rotate(begin() + iIndex, end() - 1, end());
+		invalidate();
+		return begin() + iIndex;
 	}
 
 	/**
-	* \brief Move Constructor
-	* Constructs a container that acquires the elements of bvl.
-	* If alloc is specified and is different from bvl's allocator, the elements are moved. 
-	* Otherwise, no elements are constructed (their ownership is directly transferred).
-	* bvl is left in an unspecified but valid state.
-	* \param[in] bvl	BinaryVectorList to acquire elements from.
-	* \param[in] alloc	Allocator to use for the BinaryVectorList.
+	* \brief Construct and insert an element at the end of the BinaryVector list
+	* The container is extended by inserting a new element constructed in place (using args as the arguments for its constructor) at the end of the BinaryVectorList.
+	* \tparam Args The arguments to the constructor for the element being emplaced
+	* \param[in] args		The arguments to the constructor to build the new element
+	* \return An iterator that points to the new element
 	*/
-	BinaryVectorList(BinaryVectorList&& bvl, const allocator_type& alloc = allocator_type())
+	template<typename... Args>
+	BVL_CONSTEXPR20 void emplace_back(Args&&... args)
 	{
-		m_vTvector(bvl.m_vTvector, alloc);
+		unsigned k = layout::block_of(m_uSize);
+		if (k == m_uBlocks)
+		{
+			if (grows_array())
+			{
+				//The arguments may refer to elements that are about to move
+				value_type tmp(std::forward<Args>(args)...);
+				add_block();
+				std::allocator_traits<allocator_type>::construct(m_alloc, std::addressof(m_apBlocks[k][0]), std::move(tmp));
+				++m_uSize;
+				return;
+			}
+			add_block();
+		}
+		std::allocator_traits<allocator_type>::construct(m_alloc, std::addressof(m_apBlocks[k][static_cast<size_type>(layout::offset_of(m_uSize, k))]), std::forward<Args>(args)...);
+		++m_uSize;
 	}
 
+	//Allocator
+
 	/**
-	* \brief Initializer List Constructor
-	* Constructs a container with a copy of each of the elements in il, in the same order.
-	* \param[in] il		Initializer List to copy elements from.
-	* \param[in] alloc	Allocator to use for the BinaryVectorList.
+	* \brief Get allocator object
+	* Returns a copy of the allocator object associated with the BinaryVectorList.
+	* \return A copy of the allocator object associated with the BinaryVectorList.
 	*/
-	BinaryVectorList(std::initializer_list<value_type> il, const allocator_type& alloc = allocator_type())
+	BVL_CONSTEXPR20 allocator_type get_allocator() const noexcept
 	{
-		m_vTvector(il, alloc);
+		return m_alloc;
 	}
 
-	//Destructor
+	//Operations - Most of these will be slow since they are taken from STL List, but still worth implementing.
+	/*
+	* Not implementing these on the first pass. There's no vector implementation for these.
+
+	void splice(iterator position, BinaryVectorList& x)
+	{
+
+	}
+
+	void splice(iterator position, BinaryVectorList& x, iterator i)
+	{
+
+	}
+
+	void splice(iterator position, BinaryVectorList& x, iterator first, iterator last)
+	{
+
+	}
+
+	void remove(const value_type& val)
+	{
+
+	}
+
+	template <typename Predicate>
+	void remove_if(Predicate pred)
+	{
+
+	}
+
+	void unique()
+	{
+
+	}
+
+	template <typename BinaryPredicate>
+	void unique(BinaryPredicate binary_pred)
+	{
+
+	}
+
+	void merge(BinaryVectorList& x)
+	{
+
+	}
+
+	template <typename Compare>
+	void merge(BinaryVectorList&x, Compare comp)
+	{
+
+	}
+
+	void sort()
+	{
+
+	}
+
+	template <typename Compare>
+	void sort(Compare comp)
+	{
+
+	}
+
+	void reverse()
+	{
+
+	}
+	*/
 
 	/**
-	* \brief Destructor
-	* Deallocates all of the memory used by the BinaryVectorList
+	* \brief Split the BinaryVectorList in two
+	* Removes the elements from position i on and returns them as a new list with the same allocator.
+	* Positions are fixed to blocks, so the tail has to start again at block 0 of the new list: its elements are moved there
+	* a run at a time (with memcpy for trivially copyable elements), and the blocks of this list stay allocated for it to grow back into.
+	* Splitting at 0 hands every block to the new list and moves nothing.
+	* \param[in] i The position of the first element of the new list, at most size()
+	* \return The elements [i, size()) of the list
 	*/
-	~BinaryVectorList()
+	BVL_CONSTEXPR20 BinaryVectorList split_at(size_type i)
 	{
-		//nothing to do. There is no memory to deallocate.
+		BVL_HARDENED_CHECK(i <= m_uSize, "split_at() past the end");
+		BinaryVectorList bvlTail(m_alloc);
+		pop_back_n(m_uSize - i, bvlTail);
+		return bvlTail;
 	}
 
-	//Assignment Operators
+	/**
+	* \brief Sort the elements by key with an LSD radix sort, using up to uThreads threads
+	* Keys are read a byte at a time, from the lowest. Each pass counts the bytes of every run (a piece of a block, see
+	* bvl::detail::split_runs) on its own thread, adds up the counts into where each run's share of each byte value starts,
+	* and then every run moves its elements to those places in a second list of the same layout, again one thread per run.
+	* Bytes that are equal in every key are skipped. The sort is stable. When the elements end up in the second list,
+	* its blocks are swapped in, so a compacted list is no longer contiguous afterwards.
+	* Invalidates all iterators, references and pointers.
+	* \tparam KeyFunction Returns the key of an element, an integral (other than bool) or 32 or 64 bit floating point value.
+	* It is called from several threads at once, and twice per pass for each element, so it must not throw and must return the same key each time.
+	* \param[in] key		Gives the key of an element
+	* \param[in] uThreads	Most threads to use
+	*/
+	template<typename KeyFunction>
+	void radix_sort(KeyFunction key, std::size_t uThreads)
+	{
+		typedef typename std::decay<decltype(key(std::declval<const value_type&>()))>::type key_type;
+		typedef bvl::detail::radix_key<key_type> radix_key;
+		typedef typename radix_key::unsigned_type unsigned_type;
+		static_assert(std::is_nothrow_move_constructible<value_type>::value, "radix_sort() moves elements between lists and can not undo a move that throws");
+		const std::size_t uRadix = 256;
+		size_type uSize = m_uSize;
+		std::vector<bvl::detail::position_span> vRuns = bvl::detail::split_runs(begin(), uSize);
+		uThreads = bvl::detail::parallel_threads(uSize, uThreads);
+		//A byte that is the same in every key is a pass that leaves the order as it is
+		std::vector<unsigned_type> vOr(vRuns.size(), unsigned_type(0));
+		std::vector<unsigned_type> vAnd(vRuns.size(), static_cast<unsigned_type>(~unsigned_type(0)));
+		bvl::detail::parallel_for(vRuns.size(), uThreads, [&](std::size_t r)
+		{
+			const value_type* pFirst = locate(vRuns[r].uStart);
+			for (std::size_t i = 0; i < vRuns[r].uCount; ++i)
+			{
+				unsigned_type uKey = radix_key::encode(key(pFirst[i]));
+				vOr[r] |= uKey;
+				vAnd[r] &= uKey;
+			}
+		});
+		unsigned_type uDiffer = std::accumulate(vOr.begin(), vOr.end(), unsigned_type(0), std::bit_or<unsigned_type>())
+			^ std::accumulate(vAnd.begin(), vAnd.end(), static_cast<unsigned_type>(~unsigned_type(0)), std::bit_and<unsigned_type>());
+		if (uDiffer == 0)
+		{
+			return;
+		}
+		BinaryVectorList bvlBuffer(m_alloc);
+		bvlBuffer.m_uContiguousBlocks = m_uContiguousBlocks;
+		bvlBuffer.reserve(uSize);
+		BinaryVectorList* pFrom = this;
+		BinaryVectorList* pTo = &bvlBuffer;
+		//Entry r * uRadix + b counts the elements of run r whose byte is b, then becomes where the next of them goes
+		std::vector<size_type> vNext(vRuns.size() * uRadix);
+		for (unsigned uShift = 0; uShift < sizeof(unsigned_type) * 8; uShift += 8)
+		{
+			if (((uDiffer >> uShift) & 0xFF) == 0)
+			{
+				continue;
+			}
+			std::fill(vNext.begin(), vNext.end(), size_type(0));
+			bvl::detail::parallel_for(vRuns.size(), uThreads, [&](std::size_t r)
+			{
+				const value_type* pFirst = pFrom->locate(vRuns[r].uStart);
+				size_type* pCount = vNext.data() + r * uRadix;
+				for (std::size_t i = 0; i < vRuns[r].uCount; ++i)
+				{
+					++pCount[(radix_key::encode(key(pFirst[i])) >> uShift) & 0xFF];
+				}
+			});
+			//Byte b of run r goes after every smaller byte, and after byte b of the runs before r
+			size_type uStart = 0;
+			for (std::size_t b = 0; b < uRadix; ++b)
+			{
+				for (std::size_t r = 0; r < vRuns.size(); ++r)
+				{
+					size_type uCount = vNext[r * uRadix + b];
+					vNext[r * uRadix + b] = uStart;
+					uStart += uCount;
+				}
+			}
+			bvl::detail::parallel_for(vRuns.size(), uThreads, [&](std::size_t r)
+			{
+				value_type* pFirst = pFrom->locate(vRuns[r].uStart);
+				size_type* pNext = vNext.data() + r * uRadix;
+				for (std::size_t i = 0; i < vRuns[r].uCount; ++i)
+				{
+					size_type uTo = pNext[(radix_key::encode(key(pFirst[i])) >> uShift) & 0xFF]++;
+					std::allocator_traits<allocator_type>::construct(pTo->m_alloc, pTo->locate(uTo), std::move(pFirst[i]));
+				}
+			});
+			pTo->m_uSize = uSize;
+			pFrom->clear();
+			std::swap(pFrom, pTo);
+		}
+		if (pFrom != this)
+		{
+			bvlBuffer.give_blocks(*this);
+		}
+	}
 
 	/**
-	* \brief Copy Assignment
-	* Copies all the elements from bvl into the container (with bvl preserving its contents)
-	* \param[in] bvl BinaryVectorList to copy elements from.
-	* \return Reference to this (BinaryVectorList). This allows for function chaining.
+	* \brief Sort the elements by key with an LSD radix sort on every hardware thread (see radix_sort(key, uThreads))
 	*/
-	BinaryVectorList& operator= (const BinaryVectorList& bvl)
+	template<typename KeyFunction>
+	void radix_sort(KeyFunction key)
 	{
-		m_vTvector = bvl.m_vTvector;
-		return this;
+		radix_sort(key, std::thread::hardware_concurrency());
 	}
 
 	/**
-	* \brief Move Assignment
-	* Moves the elements of bvl into the container (bvl is left in an unspecified but valid state)
-	* \param[in] bvl BinaryVectorList to copy elements from.
-	* \return Reference to this (BinaryVectorList). This allows for function chaining.
+	* \brief Sort integral or floating point elements with an LSD radix sort on every hardware thread (see radix_sort(key, uThreads))
 	*/
-	BinaryVectorList& operator= (BinaryVectorList&& bvl)
+	void radix_sort()
 	{
-		m_vTvector = bvl.m_vTvector;
-		return this;
+		radix_sort([](const value_type& val) { return val; }, std::thread::hardware_concurrency());
 	}
 
 	/**
-	* \brief Initializer List Assignment
-	* Copies the elements of il into the container.
-	* \param[in] il Initializer List to copy elements from.
-	* \return Reference to this (BinaryVectorList). This allows for function chaining.
+	* \brief Whether position n is the first element of a block. Used by the iterators to detect block crossings.
 	*/
-	BinaryVectorList& operator= (std::initializer_list<value_type> il)
+	static BVL_CONSTEXPR20 bool is_block_start(size_type n) noexcept
 	{
-		m_vTvector = bvl.m_vTvector;
-		return this;
+		return layout::is_block_start(n);
 	}
 
-	//Iterators
+protected:
+	template<typename, typename> friend class bvl::BinaryVectorListIterator;
+	template<typename, typename> friend class bvl::BinaryVectorListCursor;
+	template<typename, typename> friend class bvl::BinaryVectorListChunks;
 
 	/**
-	* \brief Return iterator to beginning
-	* Returns an iterator pointing to the first element in the BinaryVectorList.
-	* \return An iterator pointing to the first element of the BinaryVectorList
+	* \brief Number of blocks that hold elements
 	*/
-	iterator begin() noexcept
+	BVL_CONSTEXPR20 std::size_t chunk_count() const noexcept
 	{
-		return m_vTvector.begin();
+		return m_uSize ? layout::block_of(m_uSize - 1) + 1 : 0;
 	}
 
 	/**
-	* \brief Return const iterator to beginning
-	* Returns a const_iterator pointing to the first element in the BinaryVectorList.
-	* \return A const_iterator pointing to the first element of the BinaryVectorList
+	* \brief The elements of block k
 	*/
-	const_iterator begin() const noexcept
+	BVL_CONSTEXPR20 bvl::BinaryVectorListChunk<value_type> chunk(unsigned k) noexcept
 	{
-		return m_vTvector.begin();
+		size_type uStart = static_cast<size_type>(layout::block_start(k));
+		return bvl::BinaryVectorListChunk<value_type>(std::addressof(m_apBlocks[k][0]), std::min(static_cast<size_type>(layout::block_size(k)), m_uSize - uStart));
 	}
 
 	/**
-	* \brief Return iterator to end
-	* Returns an iterator pointing to the past-the-end element in the BinaryVectorList.
-	* \return An iterator pointing to the past-the-end element of the BinaryVectorList
+	* \brief The elements of block k
 	*/
-	iterator end() noexcept
+	BVL_CONSTEXPR20 bvl::BinaryVectorListChunk<const value_type> chunk(unsigned k) const noexcept
 	{
-		return m_vTvector.end();
+		size_type uStart = static_cast<size_type>(layout::block_start(k));
+		return bvl::BinaryVectorListChunk<const value_type>(std::addressof(m_apBlocks[k][0]), std::min(static_cast<size_type>(layout::block_size(k)), m_uSize - uStart));
 	}
 
 	/**
-	* \brief Return const iterator to end
-	* Returns a const_iterator pointing to the past-the-end element in the BinaryVectorList.
-	* \return A const_iterator pointing to the past-the-end element of the BinaryVectorList
+	* \brief Address of position n, or nullptr if n lies in a block that is not allocated
 	*/
-	const_iterator end() const noexcept
+	BVL_CONSTEXPR20 value_type* locate(size_type n) noexcept
 	{
-		return m_vTvector.end();
+		unsigned k = layout::block_of(n);
+		return k < m_uBlocks ? std::addressof(m_apBlocks[k][static_cast<size_type>(layout::offset_of(n, k))]) : nullptr;
 	}
 
 	/**
-	* \brief Return reverse iterator to the reverse beginning
-	* Returns a reverse_iterator pointing to the last element in the BinaryVectorList.
-	* \return A reverse_iterator pointing to the last element of the BinaryVectorList
+	* \brief Address of position n, or nullptr if n lies in a block that is not allocated
 	*/
-	reverse_iterator rbegin() noexcept
+	BVL_CONSTEXPR20 const value_type* locate(size_type n) const noexcept
 	{
-		return m_vTvector.rbegin();
+		unsigned k = layout::block_of(n);
+		return k < m_uBlocks ? std::addressof(m_apBlocks[k][static_cast<size_type>(layout::offset_of(n, k))]) : nullptr;
 	}
 
 	/**
-	* \brief Return const reverse iterator to the reverse beginning
-	* Returns a const_reverse_iterator pointing to the last element in the BinaryVectorList.
-	* \return A const_reverse_iterator pointing to the last element of the BinaryVectorList
+	* \brief std::move of positions [uFirst, uLast) to out, one run of plain pointers per block
 	*/
-	const_reverse_iterator rbegin() const noexcept
+	template<typename OutputIterator>
+	BVL_CONSTEXPR20 OutputIterator move_range(size_type uFirst, size_type uLast, OutputIterator out)
 	{
-		return m_vTvector.rbegin();
+		while (uFirst < uLast)
+		{
+			unsigned k = layout::block_of(uFirst);
+			size_type uRun = std::min(static_cast<size_type>(layout::block_start(k + 1)), uLast) - uFirst;
+			value_type* pFirst = locate(uFirst);
+			out = std::move(pFirst, pFirst + uRun, out);
+			uFirst += uRun;
+		}
+		return out;
 	}
 
 	/**
-	* \brief Return reverse iterator to the reverse end
-	* Returns a reverse_iterator pointing to the theoretical element preceding the first element in the BinaryVectorList.
-	* \return A reverse_iterator pointing to the theoretical element preceding the first element of the BinaryVectorList
+	* \brief Move constructs positions [uFirst, uLast) at the end of out
 	*/
-	reverse_iterator rend() noexcept
+	BVL_CONSTEXPR20 void move_append(size_type uFirst, size_type uLast, BinaryVectorList& out)
 	{
-		return m_vTvector.rend();
+		out.reserve(out.m_uSize + (uLast - uFirst));
+		if (bvl::detail::is_constant_evaluated())
+		{
+			move_append(uFirst, uLast, out, std::false_type());
+		}
+		else
+		{
+			move_append(uFirst, uLast, out, std::integral_constant<bool, std::is_trivially_copyable<value_type>::value && bvl::detail::is_placement_allocator<allocator_type>::value>());
+		}
 	}
 
 	/**
-	* \brief Return const reverse iterator to the reverse end
-	* Returns a const_reverse_iterator pointing to the theoretical element preceding the first element in the BinaryVectorList.
-	* \return A const_reverse_iterator pointing to the theoretical element preceding the first element of the BinaryVectorList
+	* \brief memcpy of positions [uFirst, uLast) to the end of out, which has room for them. Each run ends at the nearer block end of the two lists.
 	*/
-	const_reverse_iterator rend() const noexcept
+	void move_append(size_type uFirst, size_type uLast, BinaryVectorList& out, std::true_type) noexcept
 	{
-		return m_vTvector.rend();
+		while (uFirst < uLast)
+		{
+			size_type uRun = std::min(std::min(static_cast<size_type>(layout::block_start(layout::block_of(uFirst) + 1)), uLast) - uFirst,
+				static_cast<size_type>(layout::block_start(layout::block_of(out.m_uSize) + 1)) - out.m_uSize);
+			std::memcpy(out.locate(out.m_uSize), locate(uFirst), uRun * sizeof(value_type));
+			uFirst += uRun;
+			out.m_uSize += uRun;
+		}
 	}
 
 	/**
-	* \brief Return const_iterator to beginning
-	* Returns a const_iterator pointing to the first element in the BinaryVectorList.
-	* \return A const_iterator pointing to the first element of the BinaryVectorList
+	* \brief Move constructs positions [uFirst, uLast) at the end of out, which has room for them, reading one run of plain pointers per block
 	*/
-	const_iterator cbegin() const noexcept
+	BVL_CONSTEXPR20 void move_append(size_type uFirst, size_type uLast, BinaryVectorList& out, std::false_type)
 	{
-		return m_vTvector.cbegin();
+		while (uFirst < uLast)
+		{
+			unsigned k = layout::block_of(uFirst);
+			size_type uRun = std::min(static_cast<size_type>(layout::block_start(k + 1)), uLast) - uFirst;
+			value_type* pFirst = locate(uFirst);
+			for (size_type i = 0; i < uRun; ++i)
+			{
+				std::allocator_traits<allocator_type>::construct(out.m_alloc, out.locate(out.m_uSize), std::move(pFirst[i]));
+				++out.m_uSize;
+			}
+			uFirst += uRun;
+		}
 	}
 
 	/**
-	* \brief Return const_iterator to end
-	* Returns a const_iterator pointing to the past-the-end element in the BinaryVectorList.
-	* \return A const_iterator pointing to the past-the-end element of the BinaryVectorList
+	* \brief Destroys the last n elements, one run of plain pointers per block. The blocks stay allocated.
 	*/
-	const_iterator cend() const noexcept
+	BVL_CONSTEXPR20 void destroy_back(size_type n) noexcept
 	{
-		return m_vTvector.cend();
+		size_type uFirst = m_uSize - n;
+		while (m_uSize > uFirst)
+		{
+			unsigned k = layout::block_of(m_uSize - 1);
+			size_type uStart = std::max(static_cast<size_type>(layout::block_start(k)), uFirst);
+			value_type* pFirst = locate(uStart);
+			for (size_type i = 0; i < m_uSize - uStart; ++i)
+			{
+				std::allocator_traits<allocator_type>::destroy(m_alloc, pFirst + i);
+			}
+			m_uSize = uStart;
+		}
+		invalidate();
 	}
 
 	/**
-	* \brief Return const_reverse_iterator to the reverse beginning
-	* Returns a const_reverse_iterator pointing to the last element in the BinaryVectorList.
-	* \return A const_reverse_iterator pointing to the last element of the BinaryVectorList
+	* \brief Gives every block to out, which must be empty, and takes its spare blocks in return.
+	* Each list keeps its own contiguous limit.
 	*/
-	const_reverse_iterator crbegin() const noexcept
+	BVL_CONSTEXPR20 void give_blocks(BinaryVectorList& out) noexcept
 	{
-		return m_vTvector.crbegin();
+		swap_blocks(out);
+		std::swap(m_uContiguousBlocks, out.m_uContiguousBlocks);
+		invalidate();
+		out.invalidate();
 	}
 
 	/**
-	* \brief Return const_reverse_iterator to the reverse end
-	* Returns a const_reverse_iterator pointing to the theoretical element preceding the first element in the BinaryVectorList.
-	* \return A const_reverse_iterator pointing to the theoretical element preceding the first element of the BinaryVectorList
+	* \brief Applies op(element, value) to the element at every position in [first, last), gather_batch positions at a time
 	*/
-	const_reverse_iterator crend() const noexcept
+	template<typename InputIterator, typename ValueIterator, typename Operation>
+	void scatter_apply(InputIterator first, InputIterator last, ValueIterator values, Operation op)
 	{
-		return m_vTvector.crend();
+		unsigned auBlocks[gather_batch];
+		std::uint64_t auOffsets[gather_batch];
+		while (std::size_t uCount = translate_batch(first, last, auBlocks, auOffsets))
+		{
+			for (std::size_t i = 0; i < uCount; ++i, ++values)
+			{
+				if (i + gather_prefetch_distance < uCount)
+				{
+					bvl::detail::prefetch(std::addressof(m_apBlocks[auBlocks[i + gather_prefetch_distance]][auOffsets[i + gather_prefetch_distance]]));
+				}
+				op(m_apBlocks[auBlocks[i]][auOffsets[i]], *values);
+			}
+		}
 	}
 
-	//Capacity
-
 	/**
-	* \brief Return size of BinaryVectorList
-	* Returns the number of elements in the BinaryVectorList.
-	* \return The number of elements in the BinaryVectorList.
+	* \brief Reads up to gather_batch positions from first and translates them all at once to blocks and offsets
+	* \return The number of positions read, 0 once first reaches last.
 	*/
-	size_type size() const noexcept
+	template<typename InputIterator>
+	static std::size_t translate_batch(InputIterator& first, InputIterator last, unsigned* pBlocks, std::uint64_t* pOffsets)
 	{
-		return m_vTvector.size();
+		std::uint64_t auPositions[gather_batch];
+		std::size_t uCount = 0;
+		for (; uCount < gather_batch && first != last; ++uCount, ++first)
+		{
+			auPositions[uCount] = static_cast<std::uint64_t>(*first);
+		}
+		layout::translate(auPositions, uCount, pBlocks, pOffsets);
+		return uCount;
 	}
 
 	/**
-	* \brief Return maximum size of BinaryVectorList
-	* Returns the maximum number of elements the BinaryVectorList can hold.
-	* \return The maximum number of elements the BinaryVectorList can hold.
+	* \brief Applies op for the positions in [first, last) that fall in [uLow, uHigh), like scatter_apply() on the positions it keeps
+	* Positions are kept without a branch, a random mix of kept and skipped positions would mispredict half the time.
 	*/
-	size_type max_size() const noexcept
+	template<typename InputIterator, typename ValueIterator, typename Operation>
+	void scatter_apply_range(InputIterator first, InputIterator last, ValueIterator values, size_type uLow, size_type uHigh, Operation op)
 	{
-		return m_vTvector.max_size();
+		std::uint64_t auPositions[gather_batch];
+		ValueIterator aValues[gather_batch];
+		unsigned auBlocks[gather_batch];
+		std::uint64_t auOffsets[gather_batch];
+		while (first != last)
+		{
+			std::size_t uCount = 0;
+			for (std::size_t uRead = 0; uRead < gather_batch && first != last; ++uRead, ++first, ++values)
+			{
+				size_type n = static_cast<size_type>(*first);
+				auPositions[uCount] = n;
+				aValues[uCount] = values;
+				uCount += (n - uLow < uHigh - uLow) ? 1 : 0;
+			}
+			layout::translate(auPositions, uCount, auBlocks, auOffsets);
+			for (std::size_t i = 0; i < uCount; ++i)
+			{
+				if (i + gather_prefetch_distance < uCount)
+				{
+					bvl::detail::prefetch(std::addressof(m_apBlocks[auBlocks[i + gather_prefetch_distance]][auOffsets[i + gather_prefetch_distance]]));
+				}
+				op(m_apBlocks[auBlocks[i]][auOffsets[i]], *aValues[i]);
+			}
+		}
 	}
 
 	/**
-	* \brief Change size
-	* Resizes the BinaryVectorList so that it contains n elements.
-	* \param[in] n		Number of elements to resize the BinaryVectorList to.
-	* \param[in] val	Value to fill added elements with if n is greater than the current BinaryVectorList size.
+	* \brief Splits the list into uThreads equal ranges of positions, and has each thread apply the writes that fall in its range
+	* The last range also takes the positions past the end.
 	*/
-	void resize(size_type n, const value_type val = value_type())
+	template<typename InputIterator, typename ValueIterator, typename Operation>
+	void scatter_parallel(InputIterator first, InputIterator last, ValueIterator values, unsigned uThreads, Operation op)
 	{
-		m_vTvector.resize(n, val);
+		const bool bMultiPass = std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>::value &&
+			std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<ValueIterator>::iterator_category>::value;
+		if (uThreads <= 1 || m_uSize == 0 || !bMultiPass)
+		{
+			scatter_apply(first, last, values, op);
+			return;
+		}
+		size_type uRange = (m_uSize + uThreads - 1) / uThreads;
+		std::vector<std::future<void> > vfParts;
+		for (unsigned uPart = 1; uPart < uThreads; ++uPart)
+		{
+			size_type uHigh = uPart + 1 < uThreads ? (uPart + 1) * uRange : ~size_type(0);
+			vfParts.push_back(std::async(std::launch::async, [this, first, last, values, uPart, uRange, uHigh, op]()
+			{
+				scatter_apply_range(first, last, values, uPart * uRange, uHigh, op);
+			}));
+		}
+		scatter_apply_range(first, last, values, 0, uRange, op);
+		for (std::future<void>& fPart : vfParts)
+		{
+			fPart.get();
+		}
 	}
 
 	/**
-	* \brief Return size of currently allocated storage capacity
-	* Returns the size of the storage space currently allocated for the BinaryVectorElement, expressed in terms of value_type elements.
-	* \return The size of the storage space currently allocated for the BinaryVectorElement, expressed in terms of value_type elements.
+	* \brief Copy constructs the elements of bvl into this list, which must be empty.
+	* All the blocks are allocated first, then each block is copied in one go: with memcpy for trivially copyable elements
+	* (split over threads once the list is over 2 * parallel_copy_bytes), and element by element otherwise.
 	*/
-	size_type capacity() const noexcept
+	BVL_CONSTEXPR20 void copy_elements(const BinaryVectorList& bvl)
 	{
-		return m_vTvector.capacity();
+		reserve(bvl.m_uSize);
+		if (bvl::detail::is_constant_evaluated())
+		{
+			copy_blocks(bvl, std::false_type());
+		}
+		else
+		{
+			copy_blocks(bvl, std::integral_constant<bool, std::is_trivially_copyable<value_type>::value && bvl::detail::is_placement_allocator<allocator_type>::value>());
+		}
 	}
 
 	/**
-	* \brief Test whether the BinaryVectorList is empty
-	* Returns whether the BinaryVectorList's size is 0.
-	* \return Whether the size is 0
+	* \brief Copy constructs the elements of bvl, a block at a time. If a copy throws, the list is left empty with no blocks.
 	*/
-	bool empty() const noexcept
+	BVL_CONSTEXPR20 void copy_blocks(const BinaryVectorList& bvl, std::false_type)
 	{
-		return m_vTvector.empty();
+		try
+		{
+			for (unsigned k = 0; k < bvl.chunk_count(); ++k)
+			{
+				size_type uCount = std::min(static_cast<size_type>(layout::block_size(k)), bvl.m_uSize - static_cast<size_type>(layout::block_start(k)));
+				for (size_type i = 0; i < uCount; ++i)
+				{
+					std::allocator_traits<allocator_type>::construct(m_alloc, std::addressof(m_apBlocks[k][i]), bvl.m_apBlocks[k][i]);
+					++m_uSize;
+				}
+			}
+		}
+		catch (...)
+		{
+			clear();
+			release_blocks(0);
+			throw;
+		}
 	}
 
 	/**
-	* \brief Request a change in capacity
-	* Requests that the BinaryVectorList capacity be enough to contain at least n elements.
-	* \param[in] n Minimum number of elements the BinaryVectorList should contain
+	* \brief memcpy of every block of bvl. Each thread copies an equal range of positions.
 	*/
-	void reserve(size_type n)
+	void copy_blocks(const BinaryVectorList& bvl, std::true_type)
 	{
-		m_vTvector.reserve(n);
+		std::size_t uThreads = std::min<std::size_t>(std::thread::hardware_concurrency(), bvl.m_uSize * sizeof(value_type) / parallel_copy_bytes);
+		if (uThreads <= 1)
+		{
+			copy_range_bitwise(bvl, 0, bvl.m_uSize);
+		}
+		else
+		{
+			size_type uRange = (bvl.m_uSize + uThreads - 1) / uThreads;
+			std::vector<std::future<void> > vfParts;
+			for (size_type uFirst = uRange; uFirst < bvl.m_uSize; uFirst += uRange)
+			{
+				vfParts.push_back(std::async(std::launch::async, [this, &bvl, uFirst, uRange]()
+				{
+					copy_range_bitwise(bvl, uFirst, std::min(uFirst + uRange, bvl.m_uSize));
+				}));
+			}
+			copy_range_bitwise(bvl, 0, uRange);
+			for (std::future<void>& fPart : vfParts)
+			{
+				fPart.get();
+			}
+		}
+		m_uSize = bvl.m_uSize;
 	}
 
 	/**
-	* \brief Request a down-size of capacity
-	* Requests the BinaryVectorList shrink to a capacity that matches it current size
+	* \brief memcpy of positions [uFirst, uLast) of bvl, one run per block
 	*/
-	void shrink_to_fit()
+	void copy_range_bitwise(const BinaryVectorList& bvl, size_type uFirst, size_type uLast) noexcept
 	{
-		m_vTvector.shrink_to_fit();
+		while (uFirst < uLast)
+		{
+			unsigned k = layout::block_of(uFirst);
+			size_type uRun = std::min(static_cast<size_type>(layout::block_start(k + 1)), uLast) - uFirst;
+			std::memcpy(locate(uFirst), bvl.locate(uFirst), uRun * sizeof(value_type));
+			uFirst += uRun;
+		}
 	}
 
-	//Element Access
-
 	/**
-	* \brief Access element
-	* Returns a reference to the element at position n in the BinaryVectorList.
-	* \param[in] n Position of the desired element.
-	* \return A reference to the element at position n
+	* \brief Whether the next block is added by moving the elements to a larger array (see set_contiguous_limit)
 	*/
-	reference operator[] (size_type n)
+	BVL_CONSTEXPR20 bool grows_array() const noexcept
 	{
-		return m_vTvector[n];
+		return m_uBlocks < m_uContiguousBlocks && (m_uBlocks <= 1 || m_uBlocks == m_uCompactBlocks);
 	}
 
 	/**
-	* \brief Access element
-	* Returns a const_reference to the element at position n in the BinaryVectorList.
-	* \param[in] n position of the desired element.
-	* \return A const_reference to the element at position n
+	* \brief Moves the elements into one new allocation holding blocks [0, uBlocks) back to back, and frees the old blocks
 	*/
-	const_reference operator[] (size_type n) const
+	void move_into_array(unsigned uBlocks)
 	{
-		return m_vTvector[n];
+		pointer pArray = std::allocator_traits<allocator_type>::allocate(m_alloc, static_cast<size_type>(layout::block_start(uBlocks)));
+		move_to_array(pArray, uBlocks, std::integral_constant<bool, std::is_trivially_copyable<value_type>::value && bvl::detail::is_placement_allocator<allocator_type>::value>());
+		for (unsigned k = 0; k < chunk_count(); ++k)
+		{
+			size_type uCount = std::min(static_cast<size_type>(layout::block_size(k)), m_uSize - static_cast<size_type>(layout::block_start(k)));
+			for (size_type i = 0; i < uCount; ++i)
+			{
+				std::allocator_traits<allocator_type>::destroy(m_alloc, std::addressof(m_apBlocks[k][i]));
+			}
+		}
+		release_blocks(0);
+		for (unsigned k = 0; k < uBlocks; ++k)
+		{
+			m_apBlocks[k] = pArray + static_cast<difference_type>(layout::block_start(k));
+		}
+		m_uBlocks = uBlocks;
+		m_uCompactBlocks = uBlocks;
 	}
 
 	/**
-	* \brief Access element
-	* Returns a reference to the element at position n in the BinaryVectorList.
-	* \param[in] n Position of the desired element.
-	* \return A reference to the element at position n
+	* \brief Allocates the next block at its full size, or moves to a larger array while the list is below its contiguous limit
 	*/
-	reference at(size_type n)
+	BVL_CONSTEXPR20 void add_block()
 	{
-		return m_vTvector.at(n);
+		if (grows_array())
+		{
+			move_into_array(m_uBlocks + 1);
+			return;
+		}
+		m_apBlocks[m_uBlocks] = std::allocator_traits<allocator_type>::allocate(m_alloc, static_cast<size_type>(layout::block_size(m_uBlocks)));
+		++m_uBlocks;
 	}
 
 	/**
-	* \brief Access element
-	* Returns a const_reference to the element at position n in the BinaryVectorList.
-	* \param[in] n Position of the desired element.
-	* \return A const_reference to the element at position n
+	* \brief Deallocates the blocks from uBlocks on. They must not hold any elements.
 	*/
-	const_reference at(size_type n) const
+	BVL_CONSTEXPR20 void release_blocks(unsigned uBlocks) noexcept
 	{
-		return m_vTvector.at(n);
+		for (; m_uBlocks > uBlocks && m_uBlocks > m_uCompactBlocks; --m_uBlocks)
+		{
+			std::allocator_traits<allocator_type>::deallocate(m_alloc, m_apBlocks[m_uBlocks - 1], static_cast<size_type>(layout::block_size(m_uBlocks - 1)));
+			m_apBlocks[m_uBlocks - 1] = pointer();
+		}
+		//The array from compact() can only be released as a whole
+		if (uBlocks == 0 && m_uCompactBlocks)
+		{
+			std::allocator_traits<allocator_type>::deallocate(m_alloc, m_apBlocks[0], static_cast<size_type>(layout::block_start(m_uCompactBlocks)));
+			std::fill(m_apBlocks, m_apBlocks + m_uCompactBlocks, pointer());
+			m_uBlocks = 0;
+			m_uCompactBlocks = 0;
+		}
+		invalidate();
 	}
 
 	/**
-	* \brief Access first element
-	* Returns a reference to the first element in the BinaryVectorList.
-	* \return A reference to the first element in the BinaryVectorList.
+	* \brief memcpy of the elements to pArray, with block k at offset block_start(k)
 	*/
-	reference front()
+	void move_to_array(pointer pArray, unsigned, std::true_type) noexcept
 	{
-		return m_vTvector.front();
+		for (unsigned k = 0; k < chunk_count(); ++k)
+		{
+			size_type uCount = std::min(static_cast<size_type>(layout::block_size(k)), m_uSize - static_cast<size_type>(layout::block_start(k)));
+			std::memcpy(pArray + static_cast<difference_type>(layout::block_start(k)), m_apBlocks[k], uCount * sizeof(value_type));
+		}
 	}
 
 	/**
-	* \brief Access first element
-	* Returns a const_reference to the first element in the BinaryVectorList.
-	* \return A const_reference to the first element in the BinaryVectorList.
+	* \brief Move constructs (copy constructs, if moving could throw) the elements in pArray, with block k at offset block_start(k).
+	* If that throws, whatever was constructed is destroyed and pArray is freed.
 	*/
-	const_reference front() const
+	void move_to_array(pointer pArray, unsigned uBlocks, std::false_type)
 	{
-		return m_vTvector.front();
+		size_type uDone = 0;
+		try
+		{
+			for (; uDone < m_uSize; ++uDone)
+			{
+				std::allocator_traits<allocator_type>::construct(m_alloc, pArray + static_cast<difference_type>(uDone), std::move_if_noexcept((*this)[uDone]));
+			}
+		}
+		catch (...)
+		{
+			while (uDone)
+			{
+				--uDone;
+				std::allocator_traits<allocator_type>::destroy(m_alloc, pArray + static_cast<difference_type>(uDone));
+			}
+			std::allocator_traits<allocator_type>::deallocate(m_alloc, pArray, static_cast<size_type>(layout::block_start(uBlocks)));
+			throw;
+		}
 	}
 
 	/**
-	* \brief Access last element
-	* Returns a reference to the last element in the BinaryVectorList.
-	* \return A reference to the last element in the BinaryVectorList.
+	* \brief Advances the modification counter after elements were moved or removed.
+	* Cursors look their element up again, and in hardened mode existing iterators are reported if they are used again.
 	*/
-	reference back()
+	BVL_CONSTEXPR20 void invalidate() noexcept
 	{
-		return m_vTvector.back();
+		++m_uGeneration;
 	}
 
 	/**
-	* \brief Access last element
-	* Returns a const_reference to the last element in the BinaryVectorList.
-	* \return A const_reference to the last element in the BinaryVectorList.
+	* \brief Exchanges blocks and sizes, but not allocators, with bvl
 	*/
-	const_reference back() const
+	BVL_CONSTEXPR20 void swap_blocks(BinaryVectorList& bvl) noexcept
 	{
-		return m_vTvector.back();
+		std::swap(m_apBlocks, bvl.m_apBlocks);
+		std::swap(m_uBlocks, bvl.m_uBlocks);
+		std::swap(m_uSize, bvl.m_uSize);
+		std::swap(m_uCompactBlocks, bvl.m_uCompactBlocks);
+		std::swap(m_uContiguousBlocks, bvl.m_uContiguousBlocks);
 	}
 
-	//Modifiers
+	/**
+	* The block table is kept in the object rather than on the heap, so finding an element's block
+	* is one load from memory that is usually already in the cache.
+	* Only the first m_uBlocks entries are allocated, the others are null.
+	*/
+	pointer m_apBlocks[layout::max_blocks];
+	unsigned m_uBlocks;
+	size_type m_uSize;
+	allocator_type m_alloc;
+	/**
+	* Counts the operations that moved or removed elements, push_back leaves it alone
+	*/
+	std::size_t m_uGeneration = 0;
+	/**
+	* Number of push_front minus number of pop_front (modulo 2^64), so that cursors can follow their element
+	*/
+	std::size_t m_uFrontShift = 0;
+	/**
+	* Number of leading blocks that share the one allocation made by compact(), 0 if there is none
+	*/
+	unsigned m_uCompactBlocks = 0;
+	/**
+	* Number of blocks the list keeps in one array while it grows (see set_contiguous_limit), 0 to always grow by blocks
+	*/
+	unsigned m_uContiguousBlocks = 0;
+};
+
+/**
+* \brief Bit packed BinaryVectorList.
+* Unlike std::vector<bool> this is a deliberate specialization: bits are packed 64 to a word into doubling blocks of words
+* (block 0 is 512 bits, one cache line) and the container keeps a rank directory so that
+* count(), rank() and select() don't have to scan the whole list.
+* The directory holds the number of set bits in every block and in all of the blocks before it, and, per block,
+* a Fenwick tree over the set bit counts of its complete 512 bit lines. Block k has 2^k lines, so a write through operator[]
+* updates at most k + 1 tree nodes and the counts of the blocks after it: O(log n) in place, with no deferred work.
+* The line being filled is left out of the tree and counted by popcount, so push_back and pop_back don't walk the tree:
+* a line's node is built from its children when the line is complete.
+* rank() and select() only read the directory (they are safe to call concurrently) and also take O(log n) steps.
+* \tparam allocator_type The type of allocator to use in the BinaryVectorList container. It is rebound to 64 bit words.
+*/
+template<typename allocator_type>
+class BinaryVectorList<bool, allocator_type>
+{
+public:
+	//Typedefs
+
+	typedef bool value_type;
+	typedef std::uint64_t word_type;
+	typedef typename std::allocator_traits<allocator_type>::template rebind_alloc<word_type> word_allocator_type;
+	typedef std::size_t size_type;
+	typedef std::ptrdiff_t difference_type;
 
 	/**
-	* \brief Assign BinaryVectorList content from another container
-	* Assigns new content to the BinaryVectorList, replacing its current contents with copies from the elements in [first,last), and modifying it's size accordingly.
-	* \tparam InputIterator The iterator type to a container whose elements are to be copied to the BinaryVectorList
-	* \param[in] first	InputIterator to the initial position in the container to be copied from
-	* \param[in] last	InputIterator to the final position in the container to be copied from
+	* Bit positions are laid out in blocks of 512 << k bits
 	*/
-	template <typename InputIterator>
-	void assign(InputIterator first, InputIterator last)
+	typedef bvl::detail::BlockLayout<9> layout;
+
+	/**
+	* \brief A proxy that refers to a single bit
+	*/
+	class reference
 	{
-		m_vTvector.assign(first, last);
-	}
+	public:
+		reference(const reference&) = default;
+
+		operator bool() const noexcept
+		{
+			return (*m_pWord & m_uMask) != 0;
+		}
+
+		reference& operator=(bool bValue) noexcept
+		{
+			if (bValue != static_cast<bool>(*this))
+			{
+				flip();
+			}
+			return *this;
+		}
+
+		reference& operator=(const reference& rhs) noexcept
+		{
+			return *this = static_cast<bool>(rhs);
+		}
+
+		bool operator~() const noexcept
+		{
+			return !static_cast<bool>(*this);
+		}
+
+		void flip() noexcept
+		{
+			*m_pWord ^= m_uMask;
+			m_pList->count_flip(m_uBlock, m_uLine, (*m_pWord & m_uMask) != 0);
+		}
+
+	private:
+		friend class BinaryVectorList;
+
+		reference(BinaryVectorList* pList, unsigned uBlock, size_type uLine, word_type* pWord, word_type uMask) noexcept
+			: m_pList(pList), m_uBlock(uBlock), m_uLine(uLine), m_pWord(pWord), m_uMask(uMask)
+		{
+		}
+
+		BinaryVectorList* m_pList;
+		unsigned m_uBlock;
+		size_type m_uLine;
+		word_type* m_pWord;
+		word_type m_uMask;
+	};
+
+	typedef bool const_reference;
+	typedef bvl::BinaryVectorListIndexIterator<BinaryVectorList, reference> iterator;
+	typedef bvl::BinaryVectorListIndexIterator<const BinaryVectorList, bool> const_iterator;
+	typedef std::reverse_iterator<iterator> reverse_iterator;
+	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+	//Constructors
 
 	/**
-	* \brief Assign BinaryVectorList content with copies of a value
-	* Assigns new content to the BinaryVectorList, replacing its current contents with n copies of val, and modifying it's size accordingly.
-	* \param[in] n		New size for the BinaryVectorList
-	* \param[in] val	Value to fill the container with
+	* \brief Empty Container Constructor
+	* \param[in] alloc Allocator to use for the BinaryVectorList.
 	*/
-	void assign(size_type n, const value_type& val)
+	BinaryVectorList(const allocator_type& alloc = allocator_type())
+		: m_vvWordBlocks(block_allocator_type(word_allocator_type(alloc))), m_uSize(0), m_uOnes(0), m_alloc(alloc)
 	{
-		m_vTvector.assign(n, val);
 	}
 
 	/**
-	* \brief Assign BinaryVectorList content from an initializer_list
-	* Assigns new content to the BinaryVectorList, replacing its current contents with the values from the initializer_list, and modifying it's size accordingly.
-	* \param[in] il Initializer List to copy elements from.
+	* \brief Fill Constructor
+	* \param[in] n		Number of bits to create.
+	* \param[in] val	The value of every bit.
+	* \param[in] alloc	Allocator to use for the BinaryVectorList.
 	*/
-	void assign(std::initializer_list<value_type> il)
+	BinaryVectorList(size_type n, bool val = false, const allocator_type& alloc = allocator_type())
+		: BinaryVectorList(alloc)
 	{
-		m_vTvector.assign(il);
+		assign(n, val);
 	}
 
 	/**
-	* \brief Add an element at the end of the BinaryVectorList
-	* Adds a new element at the end of the BinaryVectorList. The content of val is copied to the new element
-	* \param[in] val Value to be copied to the new element
+	* \brief Range Constructor
+	* \tparam InputIterator The iterator type to a container whose elements are converted to bits
+	* \param[in] first	Iterator to the first element to copy.
+	* \param[in] last	Iterator past the last element to copy.
+	* \param[in] alloc	Allocator to use for the BinaryVectorList.
 	*/
-	void push_back(const value_type& val)
+	template<typename InputIterator, typename = typename std::iterator_traits<InputIterator>::iterator_category>
+	BinaryVectorList(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type())
+		: BinaryVectorList(alloc)
 	{
-		m_vTvector.push_back(val);
+		assign(first, last);
 	}
 
 	/**
-	* \brief Add an element at the end of the BinaryVectorList
-	* Adds a new element at the end of the BinaryVectorList. The content of val is moved to the new element
-	* \param[in] val Value to be moved to the new element
+	* \brief Copy Constructor
+	* The word blocks and the rank directory are copied as they are.
+	* \param[in] bvl	BinaryVectorList to copy bits from.
+	* \param[in] alloc	Allocator to use for the BinaryVectorList.
 	*/
-	void push_back(value_type&& val)
+	BinaryVectorList(const BinaryVectorList& bvl, const allocator_type& alloc = allocator_type())
+		: m_vvWordBlocks(bvl.m_vvWordBlocks, block_allocator_type(word_allocator_type(alloc))), m_vvLineTrees(bvl.m_vvLineTrees),
+		m_vBlockOnes(bvl.m_vBlockOnes), m_vOnesBefore(bvl.m_vOnesBefore),
+		m_uSize(bvl.m_uSize), m_uOnes(bvl.m_uOnes), m_alloc(alloc)
 	{
-		m_vTvector.push_back(val);
 	}
 
 	/**
-	* \brief Add an element at the beginning of the BinaryVectorList
-	* Adds a new element at the beginning of the BinaryVectorList. The content of val is copied to the new element
-	* \param[in] val Value to be copied to the new element
+	* \brief Move Constructor
+	* \param[in] bvl	BinaryVectorList to acquire bits from. It is left empty.
 	*/
-	void push_front(const value_type& val)
+	BinaryVectorList(BinaryVectorList&& bvl) noexcept
+		: BinaryVectorList(bvl.m_alloc)
 	{
-		m_vTvector.insert(m_vTvector.begin(), val);
+		swap(bvl);
 	}
 
 	/**
-	* \brief Add an element at the beginning of the BinaryVectorList
-	* Adds a new element at the beginning of the BinaryVectorList. The content of val is moved to the new element
-	* \param[in] val Value to be moved to the new element
+	* \brief Initializer List Constructor
+	* \param[in] il		Initializer List to copy bits from.
+	* \param[in] alloc	Allocator to use for the BinaryVectorList.
 	*/
-	void push_front(value_type&& val)
+	BinaryVectorList(std::initializer_list<bool> il, const allocator_type& alloc = allocator_type())
+		: BinaryVectorList(alloc)
 	{
-		m_vTvector.insert(m_vTvector.begin(), val);
+		assign(il.begin(), il.end());
 	}
 
-	/**
-	* \brief Deletes the last element of the BinaryVectorList
-	* Removes the last element in the BinaryVectorList, effectively reducing the container size by 1.
-	*/
-	void pop_back()
+	//Assignment Operators
+
+	BinaryVectorList& operator= (const BinaryVectorList& bvl)
 	{
-		m_vTvector.pop_back();
+		if (this != &bvl)
+		{
+			BinaryVectorList tmp(bvl, m_alloc);
+			swap(tmp);
+		}
+		return *this;
 	}
 
-	/**
-	* \brief Deletes the first element of the BinaryVectorList
-	* Removes the first element in the BinaryVectorList, effectively reducing the container size by 1.
-	*/
-	void pop_front()
+	BinaryVectorList& operator= (BinaryVectorList&& bvl) noexcept
 	{
-		m_vTvector.erase(m_vTvector.begin());
+		if (this != &bvl)
+		{
+			clear();
+			swap(bvl);
+		}
+		return *this;
 	}
 
-	/**
-	* \brief Insert a copy of 1 element
-	* The BinaryVectorList is extended by inserting a copy of val before the element at the specified position.
-	* \param[in] position	The position where the new elements are to be inserted
-	* \param[in] val		The value be copied
-	* \return An iterator that points to the newly inserted element
-	*/
-	iterator insert(const_iterator position, const value_type& val)
+	BinaryVectorList& operator= (std::initializer_list<bool> il)
 	{
-		return m_vTvector.insert(position, val);
+		assign(il.begin(), il.end());
+		return *this;
 	}
 
-	/**
-	* \brief Insert n copies of 1 element
-	* The BinaryVectorList is extended by inserting n copies of val before the element at the specified position.
-	* \param[in] position	The position where the new elements are to be inserted
-	* \param[in] n			The number of elements to insert
-	* \param[in] val		The value be copied
-	* \return An iterator that points to the first newly inserted element
-	*/
-	iterator insert(const_iterator position, size_type n, const value_type& val)
+	//Iterators
+
+	iterator begin() noexcept { return iterator(this, 0); }
+	const_iterator begin() const noexcept { return const_iterator(this, 0); }
+	iterator end() noexcept { return iterator(this, m_uSize); }
+	const_iterator end() const noexcept { return const_iterator(this, m_uSize); }
+	reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+	const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+	reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+	const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+	const_iterator cbegin() const noexcept { return begin(); }
+	const_iterator cend() const noexcept { return end(); }
+	const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+	const_reverse_iterator crend() const noexcept { return rend(); }
+
+	//Capacity
+
+	size_type size() const noexcept
 	{
-		return m_vTvector.insert(position, n, val);
+		return m_uSize;
 	}
 
-	/**
-	* \brief Insert elements from an InputIterator
-	* The BinaryVectorList is extended by inserting copies of elements from the range [first, last) before the element at the specified position.
-	* \tparam InputIterator The iterator type to a container whose elements are to be copied to the BinaryVectorList
-	* \param[in] position	The position where the new elements are to be inserted
-	* \param[in] first		InputIterator specifying the initial position in a container to copy from
-	* \param[in] last		InputIterator specifying the final position in a container to copy from
-	* \return An iterator that points to the first newly inserted element
-	*/
-	template<typename InputIterator>
-	iterator insert(const_iterator position, InputIterator first, InputIterator last)
+	size_type max_size() const noexcept
 	{
-		return m_vTvector.insert(position, first, last);
+		return static_cast<size_type>(std::min<std::uint64_t>(std::numeric_limits<size_type>::max(),
+			std::numeric_limits<std::uint64_t>::max() - layout::first_block_size));
 	}
 
 	/**
-	* \brief Insert a moved element
-	* The BinaryVectorList is extended by inserting val before the element at the specified position. val is moved from it's old container
-	* \param[in] position	The position where the new elements are to be inserted
-	* \param[in] val		The value be moved
-	* \return An iterator that points to the newly inserted element
+	* \brief Change size
+	* \param[in] n		Number of bits to resize to.
+	* \param[in] val	Value of the added bits if n is greater than the current size.
 	*/
-	iterator insert(const_iterator position, value_type&& val)
+	void resize(size_type n, bool val = false)
 	{
-		return m_vTvector.insert(position, val);
+		while (m_uSize > n)
+		{
+			pop_back();
+		}
+		reserve(n);
+		while (m_uSize < n)
+		{
+			push_back(val);
+		}
 	}
 
 	/**
-	* \brief Insert elements from an initializer_list
-	* The BinaryVectorList is extended by inserting copies of elements from the initializer_list before the element at the specified position.
-	* \param[in] position	The position where the new elements are to be inserted
-	* \param[in] il			Initializer_list to copy from
-	* \return An iterator that points to the newly inserted element
+	* \brief Number of bits that fit in the allocated blocks
 	*/
-	iterator insert(const_iterator position, std::initializer_list<value_type> il)
+	size_type capacity() const noexcept
 	{
-		return m_vTvector.insert(position, il);
+		return static_cast<size_type>(layout::block_start(static_cast<unsigned>(m_vvWordBlocks.size())));
 	}
 
-	/**
-	* \brief Erase an element
-	* Removes a single element from the binary
-	* \param[in] position The position of the element to be remove
-	* \return An iterator that points to the new location of the element that was after the erased element.
-	*/
-	iterator erase(const_iterator position)
+	bool empty() const noexcept
 	{
-		return m_vTvector.erase(position);
+		return m_uSize == 0;
 	}
 
-	/**
-	* \brief Erase a range of elements
-	* Removes the elements in the range [first,last)
-	* \param[in] first	The position of the first element to remove
-	* \param[in] last	The position after the last element to remove
-	* \return An iterator that points to the new location of the element that was after the last erased element.
-	*/
-	iterator erase(const_iterator first, iterator last)
+	void reserve(size_type n)
 	{
-		return m_vTvector.erase(first, last);
+		if (n > max_size())
+		{
+			throw std::length_error("BinaryVectorList<bool>::reserve");
+		}
+		while (capacity() < n)
+		{
+			add_block();
+		}
 	}
 
 	/**
-	* \brief Swap BinaryVectorList content
-	* Exchanges the content of the BinaryVectorList by the content of another BinaryVectorList, bvl.
-	* \param[in] bvl The BinaryVectorList to swap contents with
+	* \brief Releases the blocks past the last bit
 	*/
-	void swap(BinaryVectorList& bvl)
+	void shrink_to_fit()
 	{
-		m_vTvector.swap(bvl.m_vTvector);
+		size_type uBlocks = m_uSize ? layout::block_of(m_uSize - 1) + 1 : 0;
+		m_vvWordBlocks.resize(uBlocks, word_block_type(word_allocator_type(m_alloc)));
+		m_vvLineTrees.resize(uBlocks);
+		m_vBlockOnes.resize(uBlocks);
+		m_vOnesBefore.resize(uBlocks);
 	}
 
-	/**
-	* \brief Empty BinaryVectorList contents
-	* Removes all elements from the BinaryVectorList, leaving the container with a size of 0.
-	*/
-	void clear() noexcept
+	//Element Access
+
+	reference operator[] (size_type n)
 	{
-		m_vTvector.clear();
+		BVL_HARDENED_CHECK(n < m_uSize, "operator[] past the end");
+		unsigned k = layout::block_of(n);
+		std::uint64_t uOffset = layout::offset_of(n, k);
+		return reference(this, k, static_cast<size_type>(uOffset >> 9), &m_vvWordBlocks[k][static_cast<size_type>(uOffset >> 6)], word_type(1) << (uOffset & 63));
 	}
 
-	/**
-	* \brief Construct and insert an element
-	* The container is extended by inserting a new element constructed in place (using args as the arguments for its constructor) at position.
-	* \tparam Args The arguments to the constructor for the element being emplaced
-	* \param[in] position	The position to add the new element
-	* \param[in] args		The arguments to the constructor to build the new element
-	* \return An iterator that points to the new element
-	*/
-	template<typename... Args>
-	iterator emplace(const_iterator position, Args&&... args)
+	bool operator[] (size_type n) const
 	{
-		return m_vTvector.emplace(position, args);
+		BVL_HARDENED_CHECK(n < m_uSize, "operator[] past the end");
+		unsigned k = layout::block_of(n);
+		std::uint64_t uOffset = layout::offset_of(n, k);
+		return ((m_vvWordBlocks[k][static_cast<size_type>(uOffset >> 6)] >> (uOffset & 63)) & 1) != 0;
 	}
 
-	/**
-	* \brief Construct and insert an element at the end of the BinaryVector list
-	* The container is extended by inserting a new element constructed in place (using args as the arguments for its constructor) at the end of the BinaryVectorList.
-	* \tparam Args The arguments to the constructor for the element being emplaced
-	* \param[in] args		The arguments to the constructor to build the new element
-	* \return An iterator that points to the new element
-	*/
-	template<typename... Args>
-	void emplace_back(Args&&... args)
+	reference at(size_type n)
 	{
-		m_vTvector.emplace_back(args);
+		if (n >= m_uSize)
+		{
+			throw std::out_of_range("BinaryVectorList<bool>::at");
+		}
+		return (*this)[n];
 	}
 
-	//Allocator
-
-	/**
-	* \brief Get allocator object
-	* Returns a copy of the allocator object associated with the BinaryVectorList.
-	* \return A copy of the allocator object associated with the BinaryVectorList.
-	*/
-	allocator_type get_allocator() const noexcept
+	bool at(size_type n) const
 	{
-		return m_vTvector.get_allocator();
+		if (n >= m_uSize)
+		{
+			throw std::out_of_range("BinaryVectorList<bool>::at");
+		}
+		return (*this)[n];
 	}
 
-	//Operations - Most of these will be slow since they are taken from STL List, but still worth implementing.
-	/*
-	* Not implementing these on the first pass. There's no vector implementation for these.
+	reference front() { return (*this)[0]; }
+	bool front() const { return (*this)[0]; }
+	reference back() { return (*this)[m_uSize - 1]; }
+	bool back() const { return (*this)[m_uSize - 1]; }
 
-	void splice(iterator position, BinaryVectorList& x)
-	{
+	//Modifiers
 
+	template <typename InputIterator>
+	void assign(InputIterator first, InputIterator last)
+	{
+		clear();
+		for (; first != last; ++first)
+		{
+			push_back(static_cast<bool>(*first));
+		}
 	}
 
-	void splice(iterator position, BinaryVectorList& x, iterator i)
+	/**
+	* \brief Assign n copies of val. Whole words are filled at once, then the rank directory is rebuilt.
+	*/
+	void assign(size_type n, bool val)
 	{
-		
+		clear();
+		reserve(n);
+		while (m_uSize < n && (m_uSize & 63))
+		{
+			push_back(val);
+		}
+		//the rest starts on a word boundary
+		const word_type uFill = val ? ~word_type(0) : 0;
+		while (n - m_uSize >= 64)
+		{
+			unsigned k = layout::block_of(m_uSize);
+			std::uint64_t uOffset = layout::offset_of(m_uSize, k);
+			size_type uWords = static_cast<size_type>(std::min<std::uint64_t>((layout::block_size(k) - uOffset) >> 6, (n - m_uSize) >> 6));
+			size_type uFirstWord = static_cast<size_type>(uOffset >> 6);
+			std::fill(m_vvWordBlocks[k].begin() + uFirstWord, m_vvWordBlocks[k].begin() + uFirstWord + uWords, uFill);
+			m_uSize += uWords * 64;
+		}
+		recount();
+		while (m_uSize < n)
+		{
+			push_back(val);
+		}
 	}
 
-	void splice(iterator position, BinaryVectorList& x, iterator first, iterator last)
+	void assign(std::initializer_list<bool> il)
 	{
-
+		assign(il.begin(), il.end());
 	}
 
-	void remove(const value_type& val)
+	/**
+	* \brief Append a bit. Constant time: the rank directory gets one tree node every 512 bits.
+	*/
+	void push_back(bool val)
 	{
-
+		if (m_uSize && (m_uSize & 511) == 0)
+		{
+			close_line();
+		}
+		unsigned k = layout::block_of(m_uSize);
+		if (k == m_vvWordBlocks.size())
+		{
+			add_block();
+		}
+		if (val)
+		{
+			std::uint64_t uOffset = layout::offset_of(m_uSize, k);
+			m_vvWordBlocks[k][static_cast<size_type>(uOffset >> 6)] |= word_type(1) << (uOffset & 63);
+			count_flip(k, static_cast<size_type>(uOffset >> 9), true);
+		}
+		++m_uSize;
 	}
 
-	template <typename Predicate>
-	void remove_if(Predicate pred)
+	/**
+	* \brief Remove the last bit. Bits past the end are kept at 0.
+	*/
+	void pop_back()
 	{
-
+		BVL_HARDENED_CHECK(m_uSize != 0, "pop_back() of an empty list");
+		--m_uSize;
+		unsigned k = layout::block_of(m_uSize);
+		std::uint64_t uOffset = layout::offset_of(m_uSize, k);
+		word_type& uWord = m_vvWordBlocks[k][static_cast<size_type>(uOffset >> 6)];
+		word_type uMask = word_type(1) << (uOffset & 63);
+		if (uWord & uMask)
+		{
+			uWord &= ~uMask;
+			count_flip(k, static_cast<size_type>(uOffset >> 9), false);
+		}
 	}
 
-	void unique()
+	void swap(BinaryVectorList& bvl) noexcept
 	{
-
+		m_vvWordBlocks.swap(bvl.m_vvWordBlocks);
+		m_vvLineTrees.swap(bvl.m_vvLineTrees);
+		m_vBlockOnes.swap(bvl.m_vBlockOnes);
+		m_vOnesBefore.swap(bvl.m_vOnesBefore);
+		std::swap(m_uSize, bvl.m_uSize);
+		std::swap(m_uOnes, bvl.m_uOnes);
+		std::swap(m_alloc, bvl.m_alloc);
 	}
 
-	template <typename BinaryPredicate>
-	void unique(BinaryPredicate binary_pred)
+	/**
+	* \brief Remove every bit. The blocks stay allocated and are zeroed.
+	* Their tree nodes are rebuilt as the lines fill up again.
+	*/
+	void clear() noexcept
 	{
+		for (size_type k = 0; k < m_vvWordBlocks.size(); ++k)
+		{
+			std::fill(m_vvWordBlocks[k].begin(), m_vvWordBlocks[k].end(), word_type(0));
+			m_vBlockOnes[k] = 0;
+			m_vOnesBefore[k] = 0;
+		}
+		m_uSize = 0;
+		m_uOnes = 0;
+	}
 
+	/**
+	* \brief Flip every bit, then rebuild the rank directory
+	*/
+	void flip() noexcept
+	{
+		for (size_type k = 0; k < m_vvWordBlocks.size() && layout::block_start(static_cast<unsigned>(k)) < m_uSize; ++k)
+		{
+			size_type uBits = static_cast<size_type>(std::min<std::uint64_t>(layout::block_size(static_cast<unsigned>(k)), m_uSize - layout::block_start(static_cast<unsigned>(k))));
+			size_type uWords = uBits >> 6;
+			for (size_type w = 0; w < uWords; ++w)
+			{
+				m_vvWordBlocks[k][w] = ~m_vvWordBlocks[k][w];
+			}
+			if (uBits & 63)
+			{
+				m_vvWordBlocks[k][uWords] ^= (word_type(1) << (uBits & 63)) - 1;
+			}
+		}
+		recount();
 	}
 
-	void merge(BinaryVectorList& x)
+	allocator_type get_allocator() const noexcept
 	{
+		return m_alloc;
+	}
 
+	//Rank and select
+
+	/**
+	* \brief Number of set bits. Constant time.
+	*/
+	size_type count() const noexcept
+	{
+		return m_uOnes;
 	}
 
-	template <typename Compare>
-	void merge(BinaryVectorList&x, Compare comp)
+	/**
+	* \brief Number of set bits in [0, n)
+	* Costs a walk of at most k + 1 nodes down the Fenwick tree of block k and a popcount of at most 8 words.
+	* \param[in] n Position to count up to. Must not be greater than size().
+	* \return The number of set bits before position n
+	*/
+	size_type rank(size_type n) const
 	{
+		if (n >= m_uSize)
+		{
+			return m_uOnes;
+		}
+		unsigned k = layout::block_of(n);
+		std::uint64_t uOffset = layout::offset_of(n, k);
+		const word_block_type& vWords = m_vvWordBlocks[k];
+		size_type uLine = static_cast<size_type>(uOffset >> 9);
+		size_type uWord = static_cast<size_type>(uOffset >> 6);
+		size_type uResult = m_vOnesBefore[k];
+		const std::vector<size_type>& vTree = m_vvLineTrees[k];
+		for (size_type uNode = uLine; uNode; uNode &= uNode - 1)
+		{
+			uResult += vTree[uNode - 1];
+		}
+		for (size_type w = uLine * 8; w < uWord; ++w)
+		{
+			uResult += bvl::detail::popcount64(vWords[w]);
+		}
+		return uResult + bvl::detail::popcount64(vWords[uWord] & ((word_type(1) << (uOffset & 63)) - 1));
+	}
 
+	/**
+	* \brief Position of the k-th set bit (0 based)
+	* Binary searches the per block counts, then descends the Fenwick tree of that block to the line, then scans at most 8 words.
+	* \param[in] k Rank of the set bit to find.
+	* \return The position of the k-th set bit, or size() if there are not more than k set bits.
+	*/
+	size_type select(size_type k) const
+	{
+		if (k >= m_uOnes)
+		{
+			return m_uSize;
+		}
+		size_type uBlocks = layout::block_of(m_uSize - 1) + 1;
+		size_type uBlock = static_cast<size_type>(std::upper_bound(m_vOnesBefore.begin(), m_vOnesBefore.begin() + uBlocks, k) - m_vOnesBefore.begin()) - 1;
+		size_type uRemaining = k - m_vOnesBefore[uBlock];
+		//the tree has 2^uBlock nodes, so the descent halves its step down from there. Past the complete lines the words are scanned.
+		const std::vector<size_type>& vTree = m_vvLineTrees[uBlock];
+		const size_type uComplete = complete_lines(static_cast<unsigned>(uBlock));
+		size_type uLine = 0;
+		for (size_type uStep = vTree.size(); uStep; uStep >>= 1)
+		{
+			if (uLine + uStep <= uComplete && vTree[uLine + uStep - 1] <= uRemaining)
+			{
+				uRemaining -= vTree[uLine + uStep - 1];
+				uLine += uStep;
+			}
+		}
+		const word_block_type& vWords = m_vvWordBlocks[uBlock];
+		size_type w = uLine * 8;
+		for (;; ++w)
+		{
+			unsigned uCount = bvl::detail::popcount64(vWords[w]);
+			if (uRemaining < uCount)
+			{
+				break;
+			}
+			uRemaining -= uCount;
+		}
+		return static_cast<size_type>(layout::block_start(static_cast<unsigned>(uBlock))) + w * 64 + bvl::detail::select64(vWords[w], static_cast<unsigned>(uRemaining));
 	}
 
-	void sort()
+protected:
+	typedef std::vector<word_type, word_allocator_type> word_block_type;
+	typedef typename std::allocator_traits<allocator_type>::template rebind_alloc<word_block_type> block_allocator_type;
+
+	/**
+	* \brief Allocates the next block of zeroed words, and its rank directory
+	*/
+	void add_block()
 	{
+		unsigned k = static_cast<unsigned>(m_vvWordBlocks.size());
+		size_type uWords = static_cast<size_type>(layout::block_size(k) >> 6);
+		m_vvWordBlocks.emplace_back(uWords, word_type(0), word_allocator_type(m_alloc));
+		m_vvLineTrees.emplace_back(uWords / 8, size_type(0));
+		m_vBlockOnes.push_back(0);
+		m_vOnesBefore.push_back(k ? m_vOnesBefore[k - 1] + m_vBlockOnes[k - 1] : 0);
+	}
 
+	/**
+	* \brief Updates the rank directory after one bit of line uLine of block k was flipped
+	* Only the counts after the bit change: the tree nodes of complete lines that cover the line and the counts of the later blocks.
+	* A list has fewer blocks than log2 of its size, and writes to the last block, where most of the bits are, have no later blocks to update.
+	* \param[in] bSet Whether the bit is now set.
+	*/
+	void count_flip(unsigned k, size_type uLine, bool bSet) noexcept
+	{
+		const size_type uDelta = bSet ? size_type(1) : ~size_type(0);
+		std::vector<size_type>& vTree = m_vvLineTrees[k];
+		const size_type uComplete = complete_lines(k);
+		for (size_type uNode = uLine + 1; uNode <= uComplete; uNode += uNode & (~uNode + 1))
+		{
+			vTree[uNode - 1] += uDelta;
+		}
+		for (size_type uNext = k + 1; uNext < m_vOnesBefore.size(); ++uNext)
+		{
+			m_vOnesBefore[uNext] += uDelta;
+		}
+		m_vBlockOnes[k] += uDelta;
+		m_uOnes += uDelta;
 	}
 
-	template <typename Compare>
-	void sort(Compare comp)
+	/**
+	* \brief Number of lines of block k before the line being filled, whose tree nodes are up to date
+	*/
+	size_type complete_lines(unsigned k) const noexcept
 	{
-
+		std::uint64_t uStart = layout::block_start(k);
+		if (m_uSize <= uStart)
+		{
+			return 0;
+		}
+		return static_cast<size_type>(std::min<std::uint64_t>(layout::block_size(k), m_uSize - uStart) >> 9);
 	}
 
-	void reverse()
+	/**
+	* \brief Builds the tree node of the line that ends at m_uSize, which is a multiple of 512
+	* Node i covers its own line and the nodes i - 1, i - 2, i - 4 ... down to i - lowbit(i) / 2, which are all complete.
+	* The node may hold a stale count from before a pop_back() or clear(), so it is rebuilt rather than updated.
+	*/
+	void close_line() noexcept
 	{
-
+		unsigned k = layout::block_of(m_uSize - 1);
+		size_type uNode = static_cast<size_type>(layout::offset_of(m_uSize - 1, k) >> 9) + 1;
+		const word_block_type& vWords = m_vvWordBlocks[k];
+		std::vector<size_type>& vTree = m_vvLineTrees[k];
+		size_type uCount = 0;
+		for (size_type w = (uNode - 1) * 8; w < uNode * 8; ++w)
+		{
+			uCount += bvl::detail::popcount64(vWords[w]);
+		}
+		for (size_type uChild = 1; uChild < (uNode & (~uNode + 1)); uChild <<= 1)
+		{
+			uCount += vTree[uNode - uChild - 1];
+		}
+		vTree[uNode - 1] = uCount;
 	}
+
+	/**
+	* \brief Rebuilds the whole rank directory from the words, after a bulk write
+	* Bits past the end are 0, so every allocated block can be counted. Each tree is built in one pass over its lines.
 	*/
+	void recount() noexcept
+	{
+		m_uOnes = 0;
+		for (size_type k = 0; k < m_vvWordBlocks.size(); ++k)
+		{
+			const word_block_type& vWords = m_vvWordBlocks[k];
+			std::vector<size_type>& vTree = m_vvLineTrees[k];
+			for (size_type uLine = 0; uLine < vTree.size(); ++uLine)
+			{
+				size_type uCount = 0;
+				for (size_type w = uLine * 8; w < uLine * 8 + 8; ++w)
+				{
+					uCount += bvl::detail::popcount64(vWords[w]);
+				}
+				vTree[uLine] = uCount;
+			}
+			//each node adds itself to its parent once it is complete, nodes are numbered from 1
+			for (size_type uNode = 1; uNode < vTree.size(); ++uNode)
+			{
+				size_type uParent = uNode + (uNode & (~uNode + 1));
+				if (uParent <= vTree.size())
+				{
+					vTree[uParent - 1] += vTree[uNode - 1];
+				}
+			}
+			m_vBlockOnes[k] = vTree.back();
+			m_vOnesBefore[k] = m_uOnes;
+			m_uOnes += vTree.back();
+		}
+	}
 
-protected:
-	//std::vector<std::vector<value_type> > m_vvTvectorList;
-	std::vector<value_type> m_vTvector;
+	std::vector<word_block_type, block_allocator_type> m_vvWordBlocks;
+	/**
+	* Per block, a Fenwick tree over the set bit counts of its lines: node i (from 1) counts lines [i - lowbit(i), i).
+	* Only the nodes of complete lines (see complete_lines()) are kept up to date, the others are rebuilt by close_line().
+	*/
+	std::vector<std::vector<size_type> > m_vvLineTrees;
+	std::vector<size_type> m_vBlockOnes;
+	std::vector<size_type> m_vOnesBefore;
+	size_type m_uSize;
+	size_type m_uOnes;
+	allocator_type m_alloc;
 };
 
+/**
+* \brief A BinaryVectorList whose blocks each start on an Alignment byte boundary, and on a page boundary once they are large.
+* SIMD kernels over its blocks can use aligned loads without peeling.
+* To keep that true the blocks are always separate allocations: compact() and set_contiguous_limit() do not pack them into one array.
+* \tparam value_type The type of elements in the BinaryVectorList container.
+* \tparam Alignment Alignment of every block in bytes.
+*/
+template<typename value_type, std::size_t Alignment = 64>
+using AlignedBinaryVectorList = BinaryVectorList<value_type, bvl::AlignedAllocator<value_type, Alignment> >;
+
 //Swap two BinaryVectorLists
 
 /**
@@ -855,7 +3619,7 @@ protected:
 * \tparam allocator_type The type of allocator used in the BinaryVectorLists.
 */
 template<typename value_type, typename allocator_type>
-void swap(BinaryVectorList<value_type, allocator_type>& bvlLeft, BinaryVectorList<value_type, allocator_type>& bvlRight)
+BVL_CONSTEXPR20 void swap(BinaryVectorList<value_type, allocator_type>& bvlLeft, BinaryVectorList<value_type, allocator_type>& bvlRight)
 {
 	bvlLeft.swap(bvlRight);
 }
@@ -869,13 +3633,13 @@ void swap(BinaryVectorList<value_type, allocator_type>& bvlLeft, BinaryVectorLis
 * \tparam allocator_type The type of allocator used in the BinaryVectorLists.
 */
 template<typename value_type, typename allocator_type>
-bool operator == (const BinaryVectorList<value_type, allocator_type>& lhs, const BinaryVectorList<value_type, allocator_type>& rhs)
+BVL_CONSTEXPR20 bool operator == (const BinaryVectorList<value_type, allocator_type>& lhs, const BinaryVectorList<value_type, allocator_type>& rhs)
 {
 	bool bResult = false;
 	if (lhs.size() == rhs.size())
 	{
 		bResult = true;
-		BinaryVectorList<value_type, allocator_type>::size_type size = lhs.size();
+		typename BinaryVectorList<value_type, allocator_type>::size_type size = lhs.size();
 		size_t i = 0;
 		for (i = 0; i < size; ++i)
 		{
@@ -900,7 +3664,7 @@ bool operator == (const BinaryVectorList<value_type, allocator_type>& lhs, const
 * \tparam allocator_type The type of allocator used in the BinaryVectorLists.
 */
 template<typename value_type, typename allocator_type>
-bool operator != (const BinaryVectorList<value_type, allocator_type>& lhs, const BinaryVectorList<value_type, allocator_type>& rhs)
+BVL_CONSTEXPR20 bool operator != (const BinaryVectorList<value_type, allocator_type>& lhs, const BinaryVectorList<value_type, allocator_type>& rhs)
 {
 	return !(lhs == rhs);
 }
@@ -915,11 +3679,11 @@ bool operator != (const BinaryVectorList<value_type, allocator_type>& lhs, const
 * \tparam allocator_type The type of allocator used in the BinaryVectorLists.
 */
 template<typename value_type, typename allocator_type>
-bool operator < (const BinaryVectorList<value_type, allocator_type>& lhs, const BinaryVectorList<value_type, allocator_type>& rhs)
+BVL_CONSTEXPR20 bool operator < (const BinaryVectorList<value_type, allocator_type>& lhs, const BinaryVectorList<value_type, allocator_type>& rhs)
 {
 	bool bResult = false;
-	BinaryVectorList<value_type, allocator_type>::size_type lhsize = lhs.size();
-	BinaryVectorList<value_type, allocator_type>::size_type rhsize = rhs.size();
+	typename BinaryVectorList<value_type, allocator_type>::size_type lhsize = lhs.size();
+	typename BinaryVectorList<value_type, allocator_type>::size_type rhsize = rhs.size();
 	size_t i = 0;
 	for (i = 0; (i < lhsize) && (i < rhsize); ++i)
 	{
@@ -939,7 +3703,7 @@ bool operator < (const BinaryVectorList<value_type, allocator_type>& lhs, const
 	if ((i == lhsize) || (i == rhsize))
 	{
 		//we made it all the way through one of the lists with "equality"
-		bResult = lhssize < rhsize;
+		bResult = lhsize < rhsize;
 	}
 	return bResult;
 }
@@ -951,9 +3715,9 @@ bool operator < (const BinaryVectorList<value_type, allocator_type>& lhs, const
 * \tparam allocator_type The type of allocator used in the BinaryVectorLists.
 */
 template<typename value_type, typename allocator_type>
-bool operator <= (const BinaryVectorList<value_type, allocator_type>& lhs, const BinaryVectorList<value_type, allocator_type>& rhs)
+BVL_CONSTEXPR20 bool operator <= (const BinaryVectorList<value_type, allocator_type>& lhs, const BinaryVectorList<value_type, allocator_type>& rhs)
 {
-	return !(rhs < lhs)
+	return !(rhs < lhs);
 }
 
 /**
@@ -963,7 +3727,7 @@ bool operator <= (const BinaryVectorList<value_type, allocator_type>& lhs, const
 * \tparam allocator_type The type of allocator used in the BinaryVectorLists.
 */
 template<typename value_type, typename allocator_type>
-bool operator > (const BinaryVectorList<value_type, allocator_type>& lhs, const BinaryVectorList<value_type, allocator_type>& rhs)
+BVL_CONSTEXPR20 bool operator > (const BinaryVectorList<value_type, allocator_type>& lhs, const BinaryVectorList<value_type, allocator_type>& rhs)
 {
 	return rhs < lhs;
 }
@@ -975,7 +3739,633 @@ bool operator > (const BinaryVectorList<value_type, allocator_type>& lhs, const
 * \tparam allocator_type The type of allocator used in the BinaryVectorLists.
 */
 template<typename value_type, typename allocator_type>
-bool operator >= (const BinaryVectorList<value_type, allocator_type>& lhs, const BinaryVectorList<value_type, allocator_type>& rhs)
+BVL_CONSTEXPR20 bool operator >= (const BinaryVectorList<value_type, allocator_type>& lhs, const BinaryVectorList<value_type, allocator_type>& rhs)
 {
 	return !(lhs < rhs);
-}
\ No newline at end of file
+}
+
+//Segmented Algorithms
+
+/**
+* Overloads of std algorithms for BinaryVectorList iterators, found by argument dependent lookup.
+* They split a range into its blocks and run the std algorithm on each block with plain pointers
+* (Austern, "Segmented Iterators and Hierarchical Algorithms"), so copy and fill of trivial types become
+* a memmove or memset per block and the other loops vectorize. Iterators of other containers take part unchanged.
+*/
+namespace bvl
+{
+	namespace detail
+	{
+		/**
+		* \brief How an algorithm walks an iterator one contiguous run at a time.
+		* Any other iterator is a single run that never ends, and is used as is.
+		*/
+		template<typename iterator_type>
+		struct segment_traits
+		{
+			typedef iterator_type local_iterator;
+
+			static BVL_CONSTEXPR20 std::size_t contiguous(const iterator_type&) noexcept { return (std::numeric_limits<std::size_t>::max)(); }
+			static BVL_CONSTEXPR20 local_iterator local(iterator_type it) { return it; }
+			/**
+			* \brief Where to carry on after uCount elements, given where the std algorithm stopped in the run
+			*/
+			static BVL_CONSTEXPR20 iterator_type next(iterator_type, local_iterator itLocal, std::size_t) { return itLocal; }
+		};
+
+		/**
+		* \brief A BinaryVectorList iterator runs to the end of its block, and is a pointer within it
+		*/
+		template<typename list_type, typename element_type>
+		struct segment_traits<BinaryVectorListIterator<list_type, element_type> >
+		{
+			typedef BinaryVectorListIterator<list_type, element_type> iterator_type;
+			typedef element_type* local_iterator;
+
+			static BVL_CONSTEXPR20 std::size_t contiguous(const iterator_type& it) noexcept { return it.contiguous(); }
+			static BVL_CONSTEXPR20 local_iterator local(const iterator_type& it) { return std::addressof(*it); }
+			static BVL_CONSTEXPR20 iterator_type next(iterator_type it, local_iterator, std::size_t uCount) { return it += static_cast<std::ptrdiff_t>(uCount); }
+		};
+
+		/**
+		* \brief Length of the next run shared by up to three iterators, at most uCount
+		*/
+		template<typename iterator_type1, typename iterator_type2>
+		BVL_CONSTEXPR20 std::size_t shared_run(std::size_t uCount, const iterator_type1& it1, const iterator_type2& it2)
+		{
+			return std::min(uCount, std::min(segment_traits<iterator_type1>::contiguous(it1), segment_traits<iterator_type2>::contiguous(it2)));
+		}
+
+		template<typename iterator_type1, typename iterator_type2, typename iterator_type3>
+		BVL_CONSTEXPR20 std::size_t shared_run(std::size_t uCount, const iterator_type1& it1, const iterator_type2& it2, const iterator_type3& it3)
+		{
+			return std::min(shared_run(uCount, it1, it2), segment_traits<iterator_type3>::contiguous(it3));
+		}
+
+		template<typename InputIterator, typename OutputIterator>
+		BVL_CONSTEXPR20 OutputIterator segmented_copy(InputIterator first, std::size_t uCount, OutputIterator result)
+		{
+			typedef segment_traits<InputIterator> in_traits;
+			typedef segment_traits<OutputIterator> out_traits;
+			while (uCount)
+			{
+				std::size_t uRun = shared_run(uCount, first, result);
+				typename in_traits::local_iterator itFirst = in_traits::local(first);
+				typename out_traits::local_iterator itResult = std::copy(itFirst, itFirst + uRun, out_traits::local(result));
+				first = in_traits::next(first, itFirst + uRun, uRun);
+				result = out_traits::next(result, itResult, uRun);
+				uCount -= uRun;
+			}
+			return result;
+		}
+
+		template<typename InputIterator, typename OutputIterator, typename UnaryOperation>
+		BVL_CONSTEXPR20 OutputIterator segmented_transform(InputIterator first, std::size_t uCount, OutputIterator result, UnaryOperation op)
+		{
+			typedef segment_traits<InputIterator> in_traits;
+			typedef segment_traits<OutputIterator> out_traits;
+			while (uCount)
+			{
+				std::size_t uRun = shared_run(uCount, first, result);
+				typename in_traits::local_iterator itFirst = in_traits::local(first);
+				typename out_traits::local_iterator itResult = std::transform(itFirst, itFirst + uRun, out_traits::local(result), op);
+				first = in_traits::next(first, itFirst + uRun, uRun);
+				result = out_traits::next(result, itResult, uRun);
+				uCount -= uRun;
+			}
+			return result;
+		}
+
+		template<typename InputIterator, typename OutputIterator>
+		BVL_CONSTEXPR20 OutputIterator copy_into(InputIterator first, InputIterator last, OutputIterator result, std::random_access_iterator_tag)
+		{
+			return segmented_copy(first, static_cast<std::size_t>(last - first), result);
+		}
+
+		template<typename InputIterator, typename OutputIterator>
+		BVL_CONSTEXPR20 OutputIterator copy_into(InputIterator first, InputIterator last, OutputIterator result, std::input_iterator_tag)
+		{
+			return std::copy(first, last, result);
+		}
+
+		template<typename InputIterator, typename OutputIterator, typename UnaryOperation>
+		BVL_CONSTEXPR20 OutputIterator transform_into(InputIterator first, InputIterator last, OutputIterator result, UnaryOperation op, std::random_access_iterator_tag)
+		{
+			return segmented_transform(first, static_cast<std::size_t>(last - first), result, op);
+		}
+
+		template<typename InputIterator, typename OutputIterator, typename UnaryOperation>
+		BVL_CONSTEXPR20 OutputIterator transform_into(InputIterator first, InputIterator last, OutputIterator result, UnaryOperation op, std::input_iterator_tag)
+		{
+			return std::transform(first, last, result, op);
+		}
+	}
+
+	/**
+	* \brief Copies [first, last) to result, one block at a time
+	* \return The end of the copied range in result
+	*/
+	template<typename list_type, typename element_type, typename OutputIterator>
+	BVL_CONSTEXPR20 OutputIterator copy(BinaryVectorListIterator<list_type, element_type> first, BinaryVectorListIterator<list_type, element_type> last, OutputIterator result)
+	{
+		return detail::segmented_copy(first, static_cast<std::size_t>(last - first), result);
+	}
+
+	/**
+	* \brief Copies [first, last) into a BinaryVectorList, one block of the destination at a time if first is random access
+	* \return The end of the copied range in result
+	*/
+	template<typename InputIterator, typename list_type, typename element_type>
+	BVL_CONSTEXPR20 BinaryVectorListIterator<list_type, element_type> copy(InputIterator first, InputIterator last, BinaryVectorListIterator<list_type, element_type> result)
+	{
+		return detail::copy_into(first, last, result, typename std::iterator_traits<InputIterator>::iterator_category());
+	}
+
+	/**
+	* \brief Copies between BinaryVectorLists, in runs that end at a block boundary of either list
+	* \return The end of the copied range in result
+	*/
+	template<typename list_type, typename element_type, typename other_list_type, typename other_element_type>
+	BVL_CONSTEXPR20 BinaryVectorListIterator<other_list_type, other_element_type> copy(BinaryVectorListIterator<list_type, element_type> first, BinaryVectorListIterator<list_type, element_type> last, BinaryVectorListIterator<other_list_type, other_element_type> result)
+	{
+		return detail::segmented_copy(first, static_cast<std::size_t>(last - first), result);
+	}
+
+	/**
+	* \brief Assigns val to every element of [first, last), one block at a time
+	*/
+	template<typename list_type, typename element_type, typename T>
+	BVL_CONSTEXPR20 void fill(BinaryVectorListIterator<list_type, element_type> first, BinaryVectorListIterator<list_type, element_type> last, const T& val)
+	{
+		std::size_t uCount = static_cast<std::size_t>(last - first);
+		while (uCount)
+		{
+			std::size_t uRun = std::min(uCount, first.contiguous());
+			element_type* pFirst = std::addressof(*first);
+			std::fill(pFirst, pFirst + uRun, val);
+			first += static_cast<std::ptrdiff_t>(uRun);
+			uCount -= uRun;
+		}
+	}
+
+	/**
+	* \brief Writes op(x) for every x in [first, last) to result, one block at a time
+	* \return The end of the written range in result
+	*/
+	template<typename list_type, typename element_type, typename OutputIterator, typename UnaryOperation>
+	BVL_CONSTEXPR20 OutputIterator transform(BinaryVectorListIterator<list_type, element_type> first, BinaryVectorListIterator<list_type, element_type> last, OutputIterator result, UnaryOperation op)
+	{
+		return detail::segmented_transform(first, static_cast<std::size_t>(last - first), result, op);
+	}
+
+	/**
+	* \brief Writes op(x) for every x in [first, last) into a BinaryVectorList, one block of the destination at a time if first is random access
+	* \return The end of the written range in result
+	*/
+	template<typename InputIterator, typename list_type, typename element_type, typename UnaryOperation>
+	BVL_CONSTEXPR20 BinaryVectorListIterator<list_type, element_type> transform(InputIterator first, InputIterator last, BinaryVectorListIterator<list_type, element_type> result, UnaryOperation op)
+	{
+		return detail::transform_into(first, last, result, op, typename std::iterator_traits<InputIterator>::iterator_category());
+	}
+
+	/**
+	* \brief Transforms between BinaryVectorLists (or in place), in runs that end at a block boundary of either list
+	* \return The end of the written range in result
+	*/
+	template<typename list_type, typename element_type, typename other_list_type, typename other_element_type, typename UnaryOperation>
+	BVL_CONSTEXPR20 BinaryVectorListIterator<other_list_type, other_element_type> transform(BinaryVectorListIterator<list_type, element_type> first, BinaryVectorListIterator<list_type, element_type> last, BinaryVectorListIterator<other_list_type, other_element_type> result, UnaryOperation op)
+	{
+		return detail::segmented_transform(first, static_cast<std::size_t>(last - first), result, op);
+	}
+
+	/**
+	* \brief Writes op(x, y) for every x in [first1, last1) and the matching y from first2 to result,
+	* in runs that end at a block boundary of any BinaryVectorList among them
+	* \return The end of the written range in result
+	*/
+	template<typename list_type, typename element_type, typename InputIterator2, typename OutputIterator, typename BinaryOperation>
+	BVL_CONSTEXPR20 OutputIterator transform(BinaryVectorListIterator<list_type, element_type> first1, BinaryVectorListIterator<list_type, element_type> last1, InputIterator2 first2, OutputIterator result, BinaryOperation op)
+	{
+		typedef detail::segment_traits<InputIterator2> in2_traits;
+		typedef detail::segment_traits<OutputIterator> out_traits;
+		std::size_t uCount = static_cast<std::size_t>(last1 - first1);
+		while (uCount)
+		{
+			std::size_t uRun = detail::shared_run(uCount, first1, first2, result);
+			element_type* pFirst1 = std::addressof(*first1);
+			typename in2_traits::local_iterator itFirst2 = in2_traits::local(first2);
+			typename out_traits::local_iterator itResult = out_traits::local(result);
+			for (std::size_t i = 0; i < uRun; ++i, ++itFirst2, ++itResult)
+			{
+				*itResult = op(pFirst1[i], *itFirst2);
+			}
+			first1 += static_cast<std::ptrdiff_t>(uRun);
+			first2 = in2_traits::next(first2, itFirst2, uRun);
+			result = out_traits::next(result, itResult, uRun);
+			uCount -= uRun;
+		}
+		return result;
+	}
+
+	/**
+	* \brief Sums init and every element of [first, last) in order, one block at a time
+	*/
+	template<typename list_type, typename element_type, typename T>
+	BVL_CONSTEXPR20 T accumulate(BinaryVectorListIterator<list_type, element_type> first, BinaryVectorListIterator<list_type, element_type> last, T init)
+	{
+		std::size_t uCount = static_cast<std::size_t>(last - first);
+		while (uCount)
+		{
+			std::size_t uRun = std::min(uCount, first.contiguous());
+			element_type* pFirst = std::addressof(*first);
+			init = std::accumulate(pFirst, pFirst + uRun, std::move(init));
+			first += static_cast<std::ptrdiff_t>(uRun);
+			uCount -= uRun;
+		}
+		return init;
+	}
+
+	/**
+	* \brief Folds every element of [first, last) into init with op, in order, one block at a time
+	*/
+	template<typename list_type, typename element_type, typename T, typename BinaryOperation>
+	BVL_CONSTEXPR20 T accumulate(BinaryVectorListIterator<list_type, element_type> first, BinaryVectorListIterator<list_type, element_type> last, T init, BinaryOperation op)
+	{
+		std::size_t uCount = static_cast<std::size_t>(last - first);
+		while (uCount)
+		{
+			std::size_t uRun = std::min(uCount, first.contiguous());
+			element_type* pFirst = std::addressof(*first);
+			init = std::accumulate(pFirst, pFirst + uRun, std::move(init), op);
+			first += static_cast<std::ptrdiff_t>(uRun);
+			uCount -= uRun;
+		}
+		return init;
+	}
+
+	/**
+	* \brief Finds the first position where [first1, last1) and the range at first2 differ, by pred, in runs that end at a block boundary of either range
+	* \return The iterators to the first difference in both ranges, or last1 and its match
+	*/
+	template<typename list_type, typename element_type, typename InputIterator2, typename BinaryPredicate>
+	BVL_CONSTEXPR20 std::pair<BinaryVectorListIterator<list_type, element_type>, InputIterator2> mismatch(BinaryVectorListIterator<list_type, element_type> first1, BinaryVectorListIterator<list_type, element_type> last1, InputIterator2 first2, BinaryPredicate pred)
+	{
+		typedef detail::segment_traits<InputIterator2> in2_traits;
+		std::size_t uCount = static_cast<std::size_t>(last1 - first1);
+		while (uCount)
+		{
+			std::size_t uRun = detail::shared_run(uCount, first1, first2);
+			element_type* pFirst1 = std::addressof(*first1);
+			std::pair<element_type*, typename in2_traits::local_iterator> pResult = std::mismatch(pFirst1, pFirst1 + uRun, in2_traits::local(first2), pred);
+			std::size_t uSame = static_cast<std::size_t>(pResult.first - pFirst1);
+			first1 += static_cast<std::ptrdiff_t>(uSame);
+			first2 = in2_traits::next(first2, pResult.second, uSame);
+			if (uSame != uRun)
+			{
+				break;
+			}
+			uCount -= uRun;
+		}
+		return std::make_pair(first1, first2);
+	}
+
+	/**
+	* \brief Finds the first position where [first1, last1) and the range at first2 differ, in runs that end at a block boundary of either range
+	* \return The iterators to the first difference in both ranges, or last1 and its match
+	*/
+	template<typename list_type, typename element_type, typename InputIterator2>
+	BVL_CONSTEXPR20 std::pair<BinaryVectorListIterator<list_type, element_type>, InputIterator2> mismatch(BinaryVectorListIterator<list_type, element_type> first1, BinaryVectorListIterator<list_type, element_type> last1, InputIterator2 first2)
+	{
+		return bvl::mismatch(first1, last1, first2, [](const element_type& lhs, const typename std::iterator_traits<InputIterator2>::value_type& rhs) { return lhs == rhs; });
+	}
+
+	namespace detail
+	{
+		/**
+		* \brief Compares run by run with runEqual (a std::equal overload). first2 must be multi pass to find the start of its next run.
+		*/
+		template<typename list_type, typename element_type, typename InputIterator2, typename RunEqual, typename BinaryPredicate>
+		BVL_CONSTEXPR20 bool segmented_equal(BinaryVectorListIterator<list_type, element_type> first1, BinaryVectorListIterator<list_type, element_type> last1, InputIterator2 first2, RunEqual runEqual, BinaryPredicate, std::forward_iterator_tag)
+		{
+			typedef segment_traits<InputIterator2> in2_traits;
+			std::size_t uCount = static_cast<std::size_t>(last1 - first1);
+			while (uCount)
+			{
+				std::size_t uRun = shared_run(uCount, first1, first2);
+				element_type* pFirst1 = std::addressof(*first1);
+				typename in2_traits::local_iterator itFirst2 = in2_traits::local(first2);
+				if (!runEqual(pFirst1, pFirst1 + uRun, itFirst2))
+				{
+					return false;
+				}
+				std::advance(itFirst2, uRun);
+				first1 += static_cast<std::ptrdiff_t>(uRun);
+				first2 = in2_traits::next(first2, itFirst2, uRun);
+				uCount -= uRun;
+			}
+			return true;
+		}
+
+		/**
+		* \brief A single pass first2 can only be read once, so it goes through mismatch, which hands back where it stopped
+		*/
+		template<typename list_type, typename element_type, typename InputIterator2, typename RunEqual, typename BinaryPredicate>
+		BVL_CONSTEXPR20 bool segmented_equal(BinaryVectorListIterator<list_type, element_type> first1, BinaryVectorListIterator<list_type, element_type> last1, InputIterator2 first2, RunEqual, BinaryPredicate pred, std::input_iterator_tag)
+		{
+			return bvl::mismatch(first1, last1, first2, pred).first == last1;
+		}
+	}
+
+	/**
+	* \brief Whether [first1, last1) equals the range at first2 by pred, compared in runs that end at a block boundary of either range
+	*/
+	template<typename list_type, typename element_type, typename InputIterator2, typename BinaryPredicate>
+	BVL_CONSTEXPR20 bool equal(BinaryVectorListIterator<list_type, element_type> first1, BinaryVectorListIterator<list_type, element_type> last1, InputIterator2 first2, BinaryPredicate pred)
+	{
+		return detail::segmented_equal(first1, last1, first2,
+			[&pred](element_type* pFirst, element_type* pLast, typename detail::segment_traits<InputIterator2>::local_iterator itFirst2) { return std::equal(pFirst, pLast, itFirst2, pred); },
+			pred, typename std::iterator_traits<InputIterator2>::iterator_category());
+	}
+
+	/**
+	* \brief Whether [first1, last1) equals the range at first2, compared in runs that end at a block boundary of either range.
+	* Runs of trivial types against pointers or another BinaryVectorList are compared with memcmp.
+	*/
+	template<typename list_type, typename element_type, typename InputIterator2>
+	BVL_CONSTEXPR20 bool equal(BinaryVectorListIterator<list_type, element_type> first1, BinaryVectorListIterator<list_type, element_type> last1, InputIterator2 first2)
+	{
+		return detail::segmented_equal(first1, last1, first2,
+			[](element_type* pFirst, element_type* pLast, typename detail::segment_traits<InputIterator2>::local_iterator itFirst2) { return std::equal(pFirst, pLast, itFirst2); },
+			[](const element_type& lhs, const typename std::iterator_traits<InputIterator2>::value_type& rhs) { return lhs == rhs; },
+			typename std::iterator_traits<InputIterator2>::iterator_category());
+	}
+}
+
+//Parallel Algorithms
+
+/**
+* Overloads of partition, stable_partition and nth_element for BinaryVectorList iterators, found by argument dependent lookup.
+* The range is cut into runs that never cross a block and hold at most parallel_grain elements. Threads work on whole runs
+* with plain pointers, and a second parallel pass fixes up the order across runs. An optional last argument caps the number
+* of threads; by default it is the number of hardware threads, and ranges under two runs per thread use fewer.
+* Predicates and comparisons are called from several threads at once.
+*/
+namespace bvl
+{
+	namespace detail
+	{
+		/**
+		* \brief Swaps the elements numbered [uFrom, uTo) of the spans in vA with the same elements of the spans in vB.
+		* Every span lies inside one block, so each step is a swap_ranges on pointers.
+		*/
+		template<typename list_type, typename element_type>
+		void swap_spans(BinaryVectorListIterator<list_type, element_type> first, const std::vector<position_span>& vA, const std::vector<position_span>& vB, std::size_t uFrom, std::size_t uTo)
+		{
+			if (uFrom == uTo)
+			{
+				return;
+			}
+			std::size_t a = 0, uOffsetA = uFrom;
+			for (; uOffsetA >= vA[a].uCount; ++a)
+			{
+				uOffsetA -= vA[a].uCount;
+			}
+			std::size_t b = 0, uOffsetB = uFrom;
+			for (; uOffsetB >= vB[b].uCount; ++b)
+			{
+				uOffsetB -= vB[b].uCount;
+			}
+			while (uFrom < uTo)
+			{
+				std::size_t uRun = std::min(std::min(vA[a].uCount - uOffsetA, vB[b].uCount - uOffsetB), uTo - uFrom);
+				element_type* pA = std::addressof(*(first + static_cast<std::ptrdiff_t>(vA[a].uStart + uOffsetA)));
+				element_type* pB = std::addressof(*(first + static_cast<std::ptrdiff_t>(vB[b].uStart + uOffsetB)));
+				std::swap_ranges(pA, pA + uRun, pB);
+				uFrom += uRun;
+				uOffsetA += uRun;
+				uOffsetB += uRun;
+				if (uOffsetA == vA[a].uCount)
+				{
+					++a;
+					uOffsetA = 0;
+				}
+				if (uOffsetB == vB[b].uCount)
+				{
+					++b;
+					uOffsetB = 0;
+				}
+			}
+		}
+
+		/**
+		* \brief Finishes a partition whose runs are each partitioned, run r starting with vTrue[r] elements that satisfy the predicate.
+		* The false elements in front of the partition point are swapped with the true elements behind it, on up to uThreads threads.
+		* \return The partition point, relative to first
+		*/
+		template<typename list_type, typename element_type>
+		std::size_t exchange_misplaced(BinaryVectorListIterator<list_type, element_type> first, const std::vector<position_span>& vRuns, const std::vector<std::size_t>& vTrue, std::size_t uThreads)
+		{
+			std::size_t uTrue = std::accumulate(vTrue.begin(), vTrue.end(), std::size_t(0));
+			std::vector<position_span> vEarlyFalse;
+			std::vector<position_span> vLateTrue;
+			std::size_t uMisplaced = 0;
+			for (std::size_t r = 0; r < vRuns.size(); ++r)
+			{
+				std::size_t uSplit = vRuns[r].uStart + vTrue[r];
+				std::size_t uEnd = vRuns[r].uStart + vRuns[r].uCount;
+				if (uSplit < uTrue && uSplit < uEnd)
+				{
+					vEarlyFalse.push_back(position_span{uSplit, std::min(uEnd, uTrue) - uSplit});
+					uMisplaced += vEarlyFalse.back().uCount;
+				}
+				std::size_t uLateStart = std::max(vRuns[r].uStart, uTrue);
+				if (uLateStart < uSplit)
+				{
+					vLateTrue.push_back(position_span{uLateStart, uSplit - uLateStart});
+				}
+			}
+			std::size_t uParts = parallel_threads(uMisplaced, uThreads);
+			parallel_for(uParts, uParts, [&](std::size_t t)
+			{
+				swap_spans(first, vEarlyFalse, vLateTrue, uMisplaced * t / uParts, uMisplaced * (t + 1) / uParts);
+			});
+			return uTrue;
+		}
+
+		/**
+		* \brief Median of a sample spread evenly over the uCount elements from first
+		*/
+		template<typename list_type, typename element_type, typename Compare>
+		typename std::remove_const<element_type>::type sample_median(BinaryVectorListIterator<list_type, element_type> first, std::size_t uCount, Compare comp)
+		{
+			const std::size_t uSamples = 31;
+			std::vector<typename std::remove_const<element_type>::type> vSample;
+			vSample.reserve(uSamples);
+			for (std::size_t i = 0; i < uSamples; ++i)
+			{
+				vSample.push_back(*(first + static_cast<std::ptrdiff_t>(uCount / uSamples * i + uCount / uSamples / 2)));
+			}
+			std::nth_element(vSample.begin(), vSample.begin() + uSamples / 2, vSample.end(), comp);
+			return vSample[uSamples / 2];
+		}
+	}
+
+	/**
+	* \brief Reorders [first, last) so that the elements that satisfy pred come first, using up to uThreads threads.
+	* Each run is partitioned on its own thread, then the false elements left in front of the partition point are swapped,
+	* in parallel, with the true elements behind it. The relative order of the elements is not kept.
+	* \return The first element that does not satisfy pred
+	*/
+	template<typename list_type, typename element_type, typename UnaryPredicate>
+	BinaryVectorListIterator<list_type, element_type> partition(BinaryVectorListIterator<list_type, element_type> first, BinaryVectorListIterator<list_type, element_type> last, UnaryPredicate pred, std::size_t uThreads)
+	{
+		std::size_t uCount = static_cast<std::size_t>(last - first);
+		uThreads = detail::parallel_threads(uCount, uThreads);
+		if (uThreads <= 1)
+		{
+			return std::partition(first, last, pred);
+		}
+		std::vector<detail::position_span> vRuns = detail::split_runs(first, uCount);
+		std::vector<std::size_t> vTrue(vRuns.size());
+		detail::parallel_for(vRuns.size(), uThreads, [&](std::size_t r)
+		{
+			element_type* pFirst = std::addressof(*(first + static_cast<std::ptrdiff_t>(vRuns[r].uStart)));
+			vTrue[r] = static_cast<std::size_t>(std::partition(pFirst, pFirst + vRuns[r].uCount, pred) - pFirst);
+		});
+		return first + static_cast<std::ptrdiff_t>(detail::exchange_misplaced(first, vRuns, vTrue, uThreads));
+	}
+
+	/**
+	* \brief Reorders [first, last) so that the elements that satisfy pred come first, on every hardware thread
+	* \return The first element that does not satisfy pred
+	*/
+	template<typename list_type, typename element_type, typename UnaryPredicate>
+	BinaryVectorListIterator<list_type, element_type> partition(BinaryVectorListIterator<list_type, element_type> first, BinaryVectorListIterator<list_type, element_type> last, UnaryPredicate pred)
+	{
+		return bvl::partition(first, last, pred, std::thread::hardware_concurrency());
+	}
+
+	/**
+	* \brief Reorders [first, last) so that the elements that satisfy pred come first, keeping their relative order, using up to uThreads threads.
+	* Each run is stable partitioned on its own thread. Then every run moves its true elements and its false elements
+	* to their final places in a buffer the size of the range, and the buffer is moved back, both in parallel.
+	* Elements whose moves can throw are partitioned by std::stable_partition on one thread.
+	* \return The first element that does not satisfy pred
+	*/
+	template<typename list_type, typename element_type, typename UnaryPredicate>
+	BinaryVectorListIterator<list_type, element_type> stable_partition(BinaryVectorListIterator<list_type, element_type> first, BinaryVectorListIterator<list_type, element_type> last, UnaryPredicate pred, std::size_t uThreads)
+	{
+		std::size_t uCount = static_cast<std::size_t>(last - first);
+		uThreads = detail::parallel_threads(uCount, uThreads);
+		if (uThreads <= 1 || !std::is_nothrow_move_constructible<element_type>::value || !std::is_nothrow_move_assignable<element_type>::value)
+		{
+			return std::stable_partition(first, last, pred);
+		}
+		std::vector<detail::position_span> vRuns = detail::split_runs(first, uCount);
+		std::vector<std::size_t> vTrue(vRuns.size());
+		detail::parallel_for(vRuns.size(), uThreads, [&](std::size_t r)
+		{
+			element_type* pFirst = std::addressof(*(first + static_cast<std::ptrdiff_t>(vRuns[r].uStart)));
+			vTrue[r] = static_cast<std::size_t>(std::stable_partition(pFirst, pFirst + vRuns[r].uCount, pred) - pFirst);
+		});
+		//Where each run's true elements and false elements go
+		std::vector<std::size_t> vTrueTo(vRuns.size());
+		std::vector<std::size_t> vFalseTo(vRuns.size());
+		std::size_t uTrue = std::accumulate(vTrue.begin(), vTrue.end(), std::size_t(0));
+		for (std::size_t r = 0, uTrueTo = 0, uFalseTo = uTrue; r < vRuns.size(); ++r)
+		{
+			vTrueTo[r] = uTrueTo;
+			vFalseTo[r] = uFalseTo;
+			uTrueTo += vTrue[r];
+			uFalseTo += vRuns[r].uCount - vTrue[r];
+		}
+		std::allocator<element_type> alloc;
+		element_type* pBuffer = std::allocator_traits<std::allocator<element_type> >::allocate(alloc, uCount);
+		detail::parallel_for(vRuns.size(), uThreads, [&](std::size_t r)
+		{
+			element_type* pFirst = std::addressof(*(first + static_cast<std::ptrdiff_t>(vRuns[r].uStart)));
+			std::uninitialized_copy(std::make_move_iterator(pFirst), std::make_move_iterator(pFirst + vTrue[r]), pBuffer + vTrueTo[r]);
+			std::uninitialized_copy(std::make_move_iterator(pFirst + vTrue[r]), std::make_move_iterator(pFirst + vRuns[r].uCount), pBuffer + vFalseTo[r]);
+		});
+		detail::parallel_for(vRuns.size(), uThreads, [&](std::size_t r)
+		{
+			element_type* pFirst = std::addressof(*(first + static_cast<std::ptrdiff_t>(vRuns[r].uStart)));
+			element_type* pFrom = pBuffer + vRuns[r].uStart;
+			std::move(pFrom, pFrom + vRuns[r].uCount, pFirst);
+			for (std::size_t i = 0; i < vRuns[r].uCount; ++i)
+			{
+				std::allocator_traits<std::allocator<element_type> >::destroy(alloc, pFrom + i);
+			}
+		});
+		std::allocator_traits<std::allocator<element_type> >::deallocate(alloc, pBuffer, uCount);
+		return first + static_cast<std::ptrdiff_t>(uTrue);
+	}
+
+	/**
+	* \brief Reorders [first, last) so that the elements that satisfy pred come first, keeping their relative order, on every hardware thread
+	* \return The first element that does not satisfy pred
+	*/
+	template<typename list_type, typename element_type, typename UnaryPredicate>
+	BinaryVectorListIterator<list_type, element_type> stable_partition(BinaryVectorListIterator<list_type, element_type> first, BinaryVectorListIterator<list_type, element_type> last, UnaryPredicate pred)
+	{
+		return bvl::stable_partition(first, last, pred, std::thread::hardware_concurrency());
+	}
+
+	/**
+	* \brief Puts the element that belongs at nth in sorted order (by comp) there, with no greater element before it
+	* and no smaller element after it, using up to uThreads threads.
+	* Quickselect on parallel partitions: the median of a sample is the pivot, [first, last) is partitioned into the elements
+	* less than it, then the ones equal to it if nth is not among the lesser ones, and the search goes on in the part that holds nth.
+	* Once the part is too small for threads, or after as many rounds as introselect allows, std::nth_element finishes on one thread.
+	*/
+	template<typename list_type, typename element_type, typename Compare>
+	void nth_element(BinaryVectorListIterator<list_type, element_type> first, BinaryVectorListIterator<list_type, element_type> nth, BinaryVectorListIterator<list_type, element_type> last, Compare comp, std::size_t uThreads)
+	{
+		typedef BinaryVectorListIterator<list_type, element_type> iterator_type;
+		unsigned uRounds = 0;
+		for (std::size_t u = static_cast<std::size_t>(last - first); u; u >>= 1)
+		{
+			uRounds += 2;
+		}
+		for (; ; --uRounds)
+		{
+			std::size_t uCount = static_cast<std::size_t>(last - first);
+			if (nth == last || uRounds == 0 || detail::parallel_threads(uCount, uThreads) <= 1)
+			{
+				std::nth_element(first, nth, last, comp);
+				return;
+			}
+			typename std::remove_const<element_type>::type pivot(detail::sample_median(first, uCount, comp));
+			iterator_type itLess = bvl::partition(first, last, [&comp, &pivot](const element_type& val) { return comp(val, pivot); }, uThreads);
+			if (nth < itLess)
+			{
+				last = itLess;
+				continue;
+			}
+			iterator_type itEqual = bvl::partition(itLess, last, [&comp, &pivot](const element_type& val) { return !comp(pivot, val); }, uThreads);
+			if (nth < itEqual)
+			{
+				return;
+			}
+			first = itEqual;
+		}
+	}
+
+	/**
+	* \brief Puts the element that belongs at nth in sorted order (by comp) there, on every hardware thread
+	*/
+	template<typename list_type, typename element_type, typename Compare>
+	void nth_element(BinaryVectorListIterator<list_type, element_type> first, BinaryVectorListIterator<list_type, element_type> nth, BinaryVectorListIterator<list_type, element_type> last, Compare comp)
+	{
+		bvl::nth_element(first, nth, last, comp, std::thread::hardware_concurrency());
+	}
+
+	/**
+	* \brief Puts the element that belongs at nth in sorted order there, on every hardware thread
+	*/
+	template<typename list_type, typename element_type>
+	void nth_element(BinaryVectorListIterator<list_type, element_type> first, BinaryVectorListIterator<list_type, element_type> nth, BinaryVectorListIterator<list_type, element_type> last)
+	{
+		bvl::nth_element(first, nth, last, std::less<typename std::remove_const<element_type>::type>(), std::thread::hardware_concurrency());
+	}
+}
@@ -0,0 +1,419 @@
+/** \file BinaryVectorListTest.cpp
+* \brief Tests of BinaryVectorList and BinaryVectorList<bool> against the standard containers
+* \author Taylor Dowlen
+* \copyright GNU General Public License v3.0
+* \warning THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "BinaryVectorList.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	template<typename List, typename Model>
+	bool same_elements(const List& list, const Model& model)
+	{
+		return list.size() == model.size() && std::equal(model.begin(), model.end(), list.begin());
+	}
+
+	/**
+	* \brief Random edits of a list of strings, which are not trivially copyable, mirrored on a std::vector
+	*/
+	void test_model()
+	{
+		std::mt19937_64 rng(3);
+		BinaryVectorList<std::string> list;
+		std::vector<std::string> model;
+		bool bSame = true;
+		for (int iStep = 0; iStep < 20000; ++iStep)
+		{
+			std::string sValue = std::to_string(rng() % 100000) + " and some text past the small string buffer";
+			std::size_t uAt = model.empty() ? 0 : static_cast<std::size_t>(rng() % model.size());
+			switch (rng() % 8)
+			{
+			case 0:
+			case 1:
+			case 2:
+				list.push_back(sValue);
+				model.push_back(sValue);
+				break;
+			case 3:
+				list.push_front(sValue);
+				model.insert(model.begin(), sValue);
+				break;
+			case 4:
+				list.insert(list.begin() + static_cast<std::ptrdiff_t>(uAt), sValue);
+				model.insert(model.begin() + static_cast<std::ptrdiff_t>(uAt), sValue);
+				break;
+			case 5:
+				if (!model.empty())
+				{
+					list.erase(list.begin() + static_cast<std::ptrdiff_t>(uAt));
+					model.erase(model.begin() + static_cast<std::ptrdiff_t>(uAt));
+				}
+				break;
+			case 6:
+				if (!model.empty())
+				{
+					list.pop_back();
+					model.pop_back();
+				}
+				break;
+			default:
+				if (!model.empty())
+				{
+					list.pop_front();
+					model.erase(model.begin());
+				}
+				break;
+			}
+			if (iStep % 1000 == 0)
+			{
+				bSame = bSame && same_elements(list, model);
+			}
+		}
+		BVL_CHECK(bSame);
+		BVL_CHECK(same_elements(list, model));
+
+		BinaryVectorList<std::string> copy(list);
+		BVL_CHECK(same_elements(copy, model));
+		list.compact();
+		BVL_CHECK(same_elements(list, model));
+		BinaryVectorList<std::string> moved(std::move(copy));
+		BVL_CHECK(same_elements(moved, model));
+		list.resize(model.size() / 2);
+		model.resize(model.size() / 2);
+		BVL_CHECK(same_elements(list, model));
+		list.resize(model.size() * 3, "filled");
+		model.resize(model.size() * 3, "filled");
+		BVL_CHECK(same_elements(list, model));
+	}
+
+	/**
+	* \brief Checks count(), rank() and select() of list against a scan of the model
+	*/
+	bool same_ranks(const BinaryVectorList<bool>& list, const std::vector<bool>& model)
+	{
+		if (!same_elements(list, model))
+		{
+			return false;
+		}
+		std::size_t uOnes = 0;
+		for (std::size_t i = 0; i < model.size(); ++i)
+		{
+			if (list.rank(i) != uOnes)
+			{
+				return false;
+			}
+			if (model[i])
+			{
+				if (list.select(uOnes) != i)
+				{
+					return false;
+				}
+				++uOnes;
+			}
+		}
+		return list.count() == uOnes && list.rank(model.size()) == uOnes && list.select(uOnes) == model.size();
+	}
+
+	void test_bool_rank_select()
+	{
+		std::mt19937_64 rng(5);
+		BinaryVectorList<bool> list;
+		std::vector<bool> model;
+		//sparse bits, then dense ones, over several blocks
+		for (std::size_t i = 0; i < 70000; ++i)
+		{
+			bool bValue = i < 30000 ? rng() % 17 == 0 : rng() % 3 != 0;
+			list.push_back(bValue);
+			model.push_back(bValue);
+		}
+		BVL_CHECK(same_ranks(list, model));
+
+		//writes through references, single flips and pops, with the directory checked after each round
+		for (int iRound = 0; iRound < 4; ++iRound)
+		{
+			for (int i = 0; i < 5000; ++i)
+			{
+				std::size_t n = static_cast<std::size_t>(rng() % model.size());
+				switch (rng() % 3)
+				{
+				case 0:
+					list[n] = true;
+					model[n] = true;
+					break;
+				case 1:
+					list[n] = false;
+					model[n] = false;
+					break;
+				default:
+					list[n].flip();
+					model[n] = !model[n];
+					break;
+				}
+			}
+			for (int i = 0; i < 3000; ++i)
+			{
+				list.pop_back();
+				model.pop_back();
+			}
+			BVL_CHECK(same_ranks(list, model));
+		}
+
+		//growing again over popped bits, which must read back as 0
+		for (int i = 0; i < 20000; ++i)
+		{
+			list.push_back(false);
+			model.push_back(false);
+		}
+		list.back() = true;
+		model.back() = true;
+		BVL_CHECK(same_ranks(list, model));
+
+		list.flip();
+		model.flip();
+		BVL_CHECK(same_ranks(list, model));
+
+		BinaryVectorList<bool> copy(list);
+		copy[0].flip();
+		BVL_CHECK(same_ranks(list, model));
+		model[0] = !model[0];
+		BVL_CHECK(same_ranks(copy, model));
+
+		list.assign(40000, true);
+		BVL_CHECK(same_ranks(list, std::vector<bool>(40000, true)));
+		list.clear();
+		BVL_CHECK(list.count() == 0 && list.select(0) == 0);
+		list.push_back(true);
+		BVL_CHECK(list.count() == 1 && list.rank(1) == 1 && list.select(0) == 0);
+	}
+
+	/**
+	* \brief Range sizes for the parallel algorithms: inside one run, across blocks but under two runs, and many runs across blocks
+	*/
+	const std::size_t g_auParallelSizes[] = { 1000, 70000, 5 * bvl::detail::parallel_grain - 123 };
+	const std::size_t g_auThreads[] = { 1, 2, 4 };
+
+	/**
+	* \brief (key, position) pairs with many equal keys, so stable_partition's order is observable
+	*/
+	std::vector<std::pair<int, int> > keyed_values(std::size_t uCount, std::uint64_t uSeed)
+	{
+		std::mt19937_64 rng(uSeed);
+		std::vector<std::pair<int, int> > vValues(uCount);
+		for (std::size_t i = 0; i < uCount; ++i)
+		{
+			vValues[i] = std::make_pair(static_cast<int>(rng() % 1000) - 500, static_cast<int>(i));
+		}
+		return vValues;
+	}
+
+	void test_partition()
+	{
+		typedef std::pair<int, int> value_type;
+		auto isNegative = [](const value_type& val) { return val.first < 0; };
+		auto isEven = [](const value_type& val) { return val.first % 2 == 0; };
+		bool bPartition = true;
+		bool bStable = true;
+		for (std::size_t uCount : g_auParallelSizes)
+		{
+			for (std::size_t uThreads : g_auThreads)
+			{
+				std::vector<value_type> vModel = keyed_values(uCount, uCount + uThreads);
+				//the range starts inside the first block, so no run is aligned with it
+				BinaryVectorList<value_type> list;
+				list.push_back(value_type(9999, -1));
+				list.insert(list.end(), vModel.begin(), vModel.end());
+
+				auto itSplit = bvl::partition(list.begin() + 1, list.end(), isNegative, uThreads);
+				std::vector<value_type> vSorted(list.begin() + 1, list.end());
+				std::vector<value_type> vExpected(vModel);
+				std::sort(vSorted.begin(), vSorted.end());
+				std::sort(vExpected.begin(), vExpected.end());
+				bPartition = bPartition && list[0] == value_type(9999, -1) && vSorted == vExpected
+					&& itSplit - (list.begin() + 1) == std::count_if(vModel.begin(), vModel.end(), isNegative)
+					&& std::all_of(list.begin() + 1, itSplit, isNegative) && std::none_of(itSplit, list.end(), isNegative);
+
+				list.assign(vModel.begin(), vModel.end());
+				list.push_front(value_type(9999, -1));
+				itSplit = bvl::stable_partition(list.begin() + 1, list.end(), isEven, uThreads);
+				auto itModelSplit = std::stable_partition(vModel.begin(), vModel.end(), isEven);
+				bStable = bStable && list[0] == value_type(9999, -1) && std::equal(vModel.begin(), vModel.end(), list.begin() + 1)
+					&& itSplit - (list.begin() + 1) == itModelSplit - vModel.begin();
+			}
+		}
+		BVL_CHECK(bPartition);
+		BVL_CHECK(bStable);
+
+		//every element on one side
+		BinaryVectorList<int> all(3 * bvl::detail::parallel_grain, 1);
+		BVL_CHECK(bvl::partition(all.begin(), all.end(), [](int i) { return i == 1; }, 4) == all.end());
+		BVL_CHECK(bvl::stable_partition(all.begin(), all.end(), [](int i) { return i == 0; }, 4) == all.begin());
+	}
+
+	void test_nth_element()
+	{
+		bool bSame = true;
+		for (std::size_t uCount : g_auParallelSizes)
+		{
+			for (std::size_t uThreads : g_auThreads)
+			{
+				std::mt19937_64 rng(uCount * 7 + uThreads);
+				std::vector<std::int64_t> vModel(uCount);
+				for (std::int64_t& iValue : vModel)
+				{
+					//many duplicates in some ranges, almost none in others
+					iValue = static_cast<std::int64_t>(rng() % (uThreads == 2 ? 50 : 1000000000));
+				}
+				std::vector<std::int64_t> vSorted(vModel);
+				std::sort(vSorted.begin(), vSorted.end());
+				std::vector<std::int64_t> vDescending(vSorted.rbegin(), vSorted.rend());
+				for (std::size_t uNth : { std::size_t(0), uCount / 3, uCount - 1 })
+				{
+					BinaryVectorList<std::int64_t> list(vModel.begin(), vModel.end());
+					auto itNth = list.begin() + static_cast<std::ptrdiff_t>(uNth);
+					bvl::nth_element(list.begin(), itNth, list.end(), std::less<std::int64_t>(), uThreads);
+					bSame = bSame && *itNth == vSorted[uNth]
+						&& std::all_of(list.begin(), itNth, [&](std::int64_t i) { return i <= *itNth; })
+						&& std::all_of(itNth, list.end(), [&](std::int64_t i) { return i >= *itNth; });
+
+					//a custom comparison
+					list.assign(vModel.begin(), vModel.end());
+					itNth = list.begin() + static_cast<std::ptrdiff_t>(uNth);
+					bvl::nth_element(list.begin(), itNth, list.end(), std::greater<std::int64_t>(), uThreads);
+					bSame = bSame && *itNth == vDescending[uNth]
+						&& std::all_of(list.begin(), itNth, [&](std::int64_t i) { return i >= *itNth; })
+						&& std::all_of(itNth, list.end(), [&](std::int64_t i) { return i <= *itNth; });
+				}
+			}
+		}
+		BVL_CHECK(bSame);
+	}
+
+	/**
+	* \brief The order radix_sort gives floating point keys: by value, with -0.0 before 0.0
+	*/
+	template<typename float_type>
+	bool float_before(float_type a, float_type b)
+	{
+		return a < b || (a == b && std::signbit(a) && !std::signbit(b));
+	}
+
+	/**
+	* \brief Sorts a copy of vModel with radix_sort(key, uThreads) and compares it with std::stable_sort by less on the keys
+	*/
+	template<typename value_type, typename KeyFunction, typename Less>
+	bool radix_sorts(const std::vector<value_type>& vModel, KeyFunction key, Less less, std::size_t uThreads, bool bCompact)
+	{
+		BinaryVectorList<value_type> list(vModel.begin(), vModel.end());
+		if (bCompact)
+		{
+			list.compact();
+		}
+		list.radix_sort(key, uThreads);
+		std::vector<value_type> vSorted(vModel);
+		std::stable_sort(vSorted.begin(), vSorted.end(), [&](const value_type& a, const value_type& b) { return less(key(a), key(b)); });
+		return same_elements(list, vSorted);
+	}
+
+	void test_radix_sort()
+	{
+		std::mt19937_64 rng(29);
+		bool bSigned = true;
+		bool bFloat = true;
+		bool bCustom = true;
+		for (std::size_t uCount : g_auParallelSizes)
+		{
+			for (std::size_t uThreads : { std::size_t(1), std::size_t(4) })
+			{
+				bool bCompact = uCount == 70000;
+
+				//signed keys through a key function, with the positions as payload so stability shows
+				std::vector<std::pair<std::int64_t, int> > vSigned(uCount);
+				for (std::size_t i = 0; i < uCount; ++i)
+				{
+					std::int64_t iKey = static_cast<std::int64_t>(rng() % 2001) - 1000;
+					if (i % 97 == 0)
+					{
+						iKey = i % 2 ? std::numeric_limits<std::int64_t>::min() : std::numeric_limits<std::int64_t>::max();
+					}
+					else if (i % 5 == 0)
+					{
+						iKey *= std::int64_t(1) << 40;
+					}
+					vSigned[i] = std::make_pair(iKey, static_cast<int>(i));
+				}
+				bSigned = bSigned && radix_sorts(vSigned, [](const std::pair<std::int64_t, int>& val) { return val.first; }, std::less<std::int64_t>(), uThreads, bCompact);
+				std::vector<std::int8_t> vSmall(uCount);
+				for (std::int8_t& iValue : vSmall)
+				{
+					iValue = static_cast<std::int8_t>(static_cast<int>(rng() % 256) - 128);
+				}
+				bSigned = bSigned && radix_sorts(vSmall, [](std::int8_t i) { return i; }, std::less<std::int8_t>(), uThreads, bCompact);
+
+				//floats and doubles of both signs, both zeros, infinities and denormals
+				std::vector<float> vFloats(uCount);
+				std::vector<double> vDoubles(uCount);
+				const double adSpecial[] = { 0.0, -0.0, std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(),
+					std::numeric_limits<double>::denorm_min(), -std::numeric_limits<double>::denorm_min(), std::numeric_limits<double>::max(), -std::numeric_limits<double>::max() };
+				for (std::size_t i = 0; i < uCount; ++i)
+				{
+					double dValue = i % 11 == 0 ? adSpecial[(i / 11) % 8] : (static_cast<double>(rng() % 2000001) - 1000000.0) / 64.0;
+					vDoubles[i] = dValue;
+					vFloats[i] = i % 11 == 0 && (i / 11) % 8 >= 4 ? (dValue < 0 ? -1.0f : 1.0f) * std::numeric_limits<float>::denorm_min() : static_cast<float>(dValue);
+				}
+				bFloat = bFloat && radix_sorts(vFloats, [](float f) { return f; }, float_before<float>, uThreads, bCompact);
+				bFloat = bFloat && radix_sorts(vDoubles, [](double d) { return d; }, float_before<double>, uThreads, bCompact);
+
+				//a custom key on non-trivial elements: strings by length, longest first
+				std::vector<std::string> vStrings(uCount / 10);
+				for (std::size_t i = 0; i < vStrings.size(); ++i)
+				{
+					vStrings[i] = std::string(rng() % 40, 'a') + std::to_string(i);
+				}
+				bCustom = bCustom && radix_sorts(vStrings, [](const std::string& str) { return ~std::uint32_t(str.size()); }, std::less<std::uint32_t>(), uThreads, bCompact);
+			}
+		}
+		BVL_CHECK(bSigned);
+		BVL_CHECK(bFloat);
+		BVL_CHECK(bCustom);
+
+		//the default key, and keys that are all equal, which leave the order alone
+		std::vector<std::uint32_t> vValues(3 * bvl::detail::parallel_grain);
+		for (std::uint32_t& uValue : vValues)
+		{
+			uValue = static_cast<std::uint32_t>(rng());
+		}
+		BinaryVectorList<std::uint32_t> list(vValues.begin(), vValues.end());
+		list.radix_sort([](std::uint32_t) { return 7; }, 4);
+		BVL_CHECK(same_elements(list, vValues));
+		list.radix_sort();
+		std::sort(vValues.begin(), vValues.end());
+		BVL_CHECK(same_elements(list, vValues));
+	}
+}
+
+void bvl::test::run_binary_vector_list_tests()
+{
+	test_model();
+	test_bool_rank_select();
+	test_partition();
+	test_nth_element();
+	test_radix_sort();
+}
@@ -0,0 +1,708 @@
+/** \file CompressedBinaryVectorList.h
+* \brief CompressedBinaryVectorList Header File
+* \author Taylor Dowlen
+* \copyright GNU General Public License v3.0
+* \warning THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "BinaryVectorList.h"
+
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace bvl
+{
+	namespace detail
+	{
+		/**
+		* \brief Number of bits needed to hold x
+		*/
+		inline unsigned bit_width(std::uint64_t x) noexcept
+		{
+			return x ? floor_log2(x) + 1 : 0;
+		}
+
+		/**
+		* \brief The low uWidth bits set
+		*/
+		inline std::uint64_t low_mask(unsigned uWidth) noexcept
+		{
+			return uWidth >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << uWidth) - 1;
+		}
+
+		/**
+		* \brief Reads the i-th uWidth bit value from a packed buffer.
+		* The buffer must be followed by one padding word, widths up to 56 bits are read with a single unaligned load.
+		*/
+		inline std::uint64_t unpack_one(const std::uint64_t* pWords, unsigned uWidth, std::size_t i) noexcept
+		{
+			std::uint64_t uBit = static_cast<std::uint64_t>(i) * uWidth;
+			std::uint64_t uValue = 0;
+			if (uWidth <= 56)
+			{
+				std::memcpy(&uValue, reinterpret_cast<const unsigned char*>(pWords) + (uBit >> 3), sizeof(uValue));
+				return (uValue >> (uBit & 7)) & low_mask(uWidth);
+			}
+			std::size_t uWord = static_cast<std::size_t>(uBit >> 6);
+			unsigned uShift = static_cast<unsigned>(uBit & 63);
+			uValue = pWords[uWord] >> uShift;
+			if (uShift + uWidth > 64)
+			{
+				uValue |= pWords[uWord + 1] << (64 - uShift);
+			}
+			return uValue & low_mask(uWidth);
+		}
+
+		/**
+		* \brief Reads uCount consecutive uWidth bit values from a packed buffer and adds uBase to each.
+		* With AVX2 four values are extracted per step with a gather and a variable shift.
+		*/
+		inline void unpack(const std::uint64_t* pWords, unsigned uWidth, std::size_t uCount, std::uint64_t uBase, std::uint64_t* pOut) noexcept
+		{
+			std::size_t i = 0;
+			if (uWidth == 0)
+			{
+				std::fill(pOut, pOut + uCount, uBase);
+				return;
+			}
+#if defined(__AVX2__)
+			if (uWidth <= 56)
+			{
+				const long long* pBytes = reinterpret_cast<const long long*>(pWords);
+				const __m256i vMask = _mm256_set1_epi64x(static_cast<long long>(low_mask(uWidth)));
+				const __m256i vBase = _mm256_set1_epi64x(static_cast<long long>(uBase));
+				const __m256i vStep = _mm256_set1_epi64x(static_cast<long long>(uWidth) * 4);
+				const __m256i vSeven = _mm256_set1_epi64x(7);
+				__m256i vBit = _mm256_set_epi64x(3ll * uWidth, 2ll * uWidth, 1ll * uWidth, 0);
+				for (; i + 4 <= uCount; i += 4)
+				{
+					__m256i vValue = _mm256_i64gather_epi64(pBytes, _mm256_srli_epi64(vBit, 3), 1);
+					vValue = _mm256_and_si256(_mm256_srlv_epi64(vValue, _mm256_and_si256(vBit, vSeven)), vMask);
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(pOut + i), _mm256_add_epi64(vValue, vBase));
+					vBit = _mm256_add_epi64(vBit, vStep);
+				}
+			}
+#endif
+			for (; i < uCount; ++i)
+			{
+				pOut[i] = uBase + unpack_one(pWords, uWidth, i);
+			}
+		}
+
+		/**
+		* \brief Appends fixed width values to a word buffer
+		*/
+		template<typename word_vector_type>
+		class BitPacker
+		{
+		public:
+			explicit BitPacker(word_vector_type& vWords) : m_vWords(vWords), m_uBits(static_cast<std::uint64_t>(vWords.size()) * 64) {}
+
+			void put(std::uint64_t uValue, unsigned uWidth)
+			{
+				if (uWidth == 0)
+				{
+					return;
+				}
+				unsigned uShift = static_cast<unsigned>(m_uBits & 63);
+				if (uShift == 0)
+				{
+					m_vWords.push_back(0);
+				}
+				m_vWords.back() |= uValue << uShift;
+				if (uShift + uWidth > 64)
+				{
+					m_vWords.push_back(uValue >> (64 - uShift));
+				}
+				m_uBits += uWidth;
+			}
+
+		private:
+			word_vector_type& m_vWords;
+			std::uint64_t m_uBits;
+		};
+	}
+}
+
+/**
+* \brief A BinaryVectorList of integers that compresses its blocks as they fill.
+* A block is split into miniblocks of 128 values. A full miniblock never changes,
+* so each one is encoded a single time when its last element is pushed, and appended to the block it belongs to.
+* Each miniblock picks the smaller of two encodings:
+* frame of reference (the minimum plus the bit packed distance of every value from it),
+* or, when the miniblock is sorted, delta (the first value plus the bit packed differences between neighbours).
+* operator[] decodes a single value: 1 unaligned load for frame of reference, a running sum of at most 127 deltas for delta.
+* Iterators stepped with ++ or -- and decode() unpack whole miniblocks at a time (4 values per step with AVX2).
+* Only the miniblock being filled is kept uncompressed, so at most 128 raw values are held at any time.
+* \tparam integer_type The integral type of the elements.
+* \tparam allocator_type The type of allocator to use. It is rebound to the storage types.
+*/
+template<typename integer_type, typename allocator_type = std::allocator<integer_type> >
+class CompressedBinaryVectorList
+{
+	static_assert(std::is_integral<integer_type>::value, "CompressedBinaryVectorList only holds integral types");
+
+public:
+	//Typedefs
+
+	typedef integer_type value_type;
+	typedef integer_type const_reference;
+	typedef std::size_t size_type;
+	typedef std::ptrdiff_t difference_type;
+
+	/**
+	* Blocks hold 128 << k values, a whole number of miniblocks
+	*/
+	typedef bvl::detail::BlockLayout<7> layout;
+
+	/**
+	* The number of values in a miniblock, the unit of encoding
+	*/
+	static const size_type miniblock_size = 128;
+
+	/**
+	* \brief Read only random access iterator.
+	* A fresh iterator, one moved with += or -=, and it[n] read single values through the list's operator[], so a binary search
+	* decodes one value per probe. Once an iterator is stepped with ++ or --, it decodes the whole miniblock it points into
+	* and serves the rest of it from a buffer of its own. The buffer is allocated on that first step and is not copied with the iterator.
+	*/
+	class const_iterator
+	{
+	public:
+		typedef std::random_access_iterator_tag iterator_category;
+		typedef integer_type value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef void pointer;
+		typedef integer_type reference;
+
+		const_iterator() noexcept : m_pList(nullptr), m_uIndex(0), m_bSequential(false) {}
+		const_iterator(const CompressedBinaryVectorList* pList, size_type uIndex) noexcept : m_pList(pList), m_uIndex(uIndex), m_bSequential(false) {}
+		const_iterator(const const_iterator& rhs) noexcept : m_pList(rhs.m_pList), m_uIndex(rhs.m_uIndex), m_bSequential(false) {}
+		const_iterator(const_iterator&&) noexcept = default;
+
+		const_iterator& operator=(const const_iterator& rhs) noexcept
+		{
+			m_pList = rhs.m_pList;
+			m_uIndex = rhs.m_uIndex;
+			m_bSequential = false;
+			if (m_pCache)
+			{
+				m_pCache->uCount = 0;
+			}
+			return *this;
+		}
+		const_iterator& operator=(const_iterator&&) noexcept = default;
+
+		inline integer_type operator*() const
+		{
+			if (m_pCache && m_uIndex - m_pCache->uStart < m_pCache->uCount)
+			{
+				return m_pCache->aValues[m_uIndex - m_pCache->uStart];
+			}
+			if (!m_bSequential)
+			{
+				return (*m_pList)[m_uIndex];
+			}
+			if (!m_pCache)
+			{
+				m_pCache.reset(new DecodeCache);
+			}
+			//the list may have grown since the last decode, so the number of values decoded is kept with them
+			m_pCache->uStart = m_uIndex & ~(miniblock_size - 1);
+			m_pCache->uCount = std::min(miniblock_size, m_pList->size() - m_pCache->uStart);
+			m_pList->decode(m_pCache->uStart, m_pCache->uCount, m_pCache->aValues);
+			return m_pCache->aValues[m_uIndex - m_pCache->uStart];
+		}
+		inline integer_type operator[](difference_type rhs) const { return (*m_pList)[m_uIndex + rhs]; }
+
+		inline const_iterator& operator+=(difference_type rhs) { m_uIndex += rhs; m_bSequential = false; return *this; }
+		inline const_iterator& operator-=(difference_type rhs) { m_uIndex -= rhs; m_bSequential = false; return *this; }
+		inline const_iterator& operator++() { ++m_uIndex; m_bSequential = true; return *this; }
+		inline const_iterator& operator--() { --m_uIndex; m_bSequential = true; return *this; }
+		inline const_iterator operator++(int) { const_iterator tmp(*this); ++*this; return tmp; }
+		inline const_iterator operator--(int) { const_iterator tmp(*this); --*this; return tmp; }
+		inline difference_type operator-(const const_iterator& rhs) const { return static_cast<difference_type>(m_uIndex - rhs.m_uIndex); }
+		inline const_iterator operator+(difference_type rhs) const { return const_iterator(m_pList, m_uIndex + rhs); }
+		inline const_iterator operator-(difference_type rhs) const { return const_iterator(m_pList, m_uIndex - rhs); }
+		friend inline const_iterator operator+(difference_type lhs, const const_iterator& rhs) { return rhs + lhs; }
+
+		friend inline bool operator==(const const_iterator& lhs, const const_iterator& rhs) { return lhs.m_uIndex == rhs.m_uIndex; }
+		friend inline bool operator!=(const const_iterator& lhs, const const_iterator& rhs) { return lhs.m_uIndex != rhs.m_uIndex; }
+		friend inline bool operator>(const const_iterator& lhs, const const_iterator& rhs) { return lhs.m_uIndex > rhs.m_uIndex; }
+		friend inline bool operator<(const const_iterator& lhs, const const_iterator& rhs) { return lhs.m_uIndex < rhs.m_uIndex; }
+		friend inline bool operator>=(const const_iterator& lhs, const const_iterator& rhs) { return lhs.m_uIndex >= rhs.m_uIndex; }
+		friend inline bool operator<=(const const_iterator& lhs, const const_iterator& rhs) { return lhs.m_uIndex <= rhs.m_uIndex; }
+
+	private:
+		/**
+		* \brief The decoded values of the miniblock starting at uStart, uCount of them
+		*/
+		struct DecodeCache
+		{
+			size_type uStart;
+			size_type uCount;
+			integer_type aValues[miniblock_size];
+		};
+
+		const CompressedBinaryVectorList* m_pList;
+		size_type m_uIndex;
+		bool m_bSequential;
+		mutable std::unique_ptr<DecodeCache> m_pCache;
+	};
+
+	typedef const_iterator iterator;
+
+	//Constructors
+
+	/**
+	* \brief Empty Container Constructor
+	* \param[in] alloc Allocator to use for the CompressedBinaryVectorList.
+	*/
+	CompressedBinaryVectorList(const allocator_type& alloc = allocator_type())
+		: m_vEncodedBlocks(encoded_block_allocator_type(alloc)), m_vTail(alloc), m_uSize(0), m_alloc(alloc)
+	{
+		m_vTail.reserve(miniblock_size);
+	}
+
+	/**
+	* \brief Range Constructor
+	* \tparam InputIterator The iterator type to a container whose elements are to be copied
+	* \param[in] first	Iterator to the first element to copy.
+	* \param[in] last	Iterator past the last element to copy.
+	* \param[in] alloc	Allocator to use for the CompressedBinaryVectorList.
+	*/
+	template<typename InputIterator, typename = typename std::iterator_traits<InputIterator>::iterator_category>
+	CompressedBinaryVectorList(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type())
+		: CompressedBinaryVectorList(alloc)
+	{
+		for (; first != last; ++first)
+		{
+			push_back(*first);
+		}
+	}
+
+	/**
+	* \brief Initializer List Constructor
+	* \param[in] il		Initializer List to copy elements from.
+	* \param[in] alloc	Allocator to use for the CompressedBinaryVectorList.
+	*/
+	CompressedBinaryVectorList(std::initializer_list<integer_type> il, const allocator_type& alloc = allocator_type())
+		: CompressedBinaryVectorList(il.begin(), il.end(), alloc)
+	{
+	}
+
+	//Iterators
+
+	const_iterator begin() const noexcept { return const_iterator(this, 0); }
+	const_iterator end() const noexcept { return const_iterator(this, m_uSize); }
+	const_iterator cbegin() const noexcept { return begin(); }
+	const_iterator cend() const noexcept { return end(); }
+
+	//Capacity
+
+	size_type size() const noexcept
+	{
+		return m_uSize;
+	}
+
+	bool empty() const noexcept
+	{
+		return m_uSize == 0;
+	}
+
+	/**
+	* \brief Bytes of element storage in use: the encoded blocks plus the uncompressed miniblock being filled.
+	* Compare with size() * sizeof(integer_type) for the compression ratio.
+	*/
+	size_type memory_usage() const noexcept
+	{
+		size_type uBytes = m_vTail.capacity() * sizeof(integer_type);
+		for (const EncodedBlock& block : m_vEncodedBlocks)
+		{
+			uBytes += block.vHeaders.size() * sizeof(MiniblockHeader);
+			for (const word_vector_type& vChunk : block.vChunks)
+			{
+				uBytes += vChunk.size() * sizeof(std::uint64_t);
+			}
+		}
+		return uBytes;
+	}
+
+	//Element Access
+
+	/**
+	* \brief Decode a single element
+	* \param[in] n Position of the desired element.
+	* \return The element at position n, by value.
+	*/
+	integer_type operator[] (size_type n) const
+	{
+		size_type uTailStart = m_uSize - m_vTail.size();
+		if (n >= uTailStart)
+		{
+			return m_vTail[n - uTailStart];
+		}
+		unsigned k = layout::block_of(n);
+		size_type uOffset = static_cast<size_type>(layout::offset_of(n, k));
+		const EncodedBlock& block = m_vEncodedBlocks[k];
+		const MiniblockHeader& header = block.vHeaders[uOffset / miniblock_size];
+		const std::uint64_t* pWords = payload(block, header);
+		size_type uIndex = uOffset % miniblock_size;
+		std::uint64_t uKey = header.uBase;
+		if (header.uMode == mode_frame_of_reference)
+		{
+			uKey += bvl::detail::unpack_one(pWords, static_cast<unsigned>(header.uWidth), uIndex);
+		}
+		else
+		{
+			for (size_type i = 0; i < uIndex; ++i)
+			{
+				uKey += bvl::detail::unpack_one(pWords, static_cast<unsigned>(header.uWidth), i);
+			}
+		}
+		return from_key(uKey);
+	}
+
+	integer_type at(size_type n) const
+	{
+		if (n >= m_uSize)
+		{
+			throw std::out_of_range("CompressedBinaryVectorList::at");
+		}
+		return (*this)[n];
+	}
+
+	integer_type front() const { return (*this)[0]; }
+	integer_type back() const { return (*this)[m_uSize - 1]; }
+
+	/**
+	* \brief Decode a range of elements
+	* Whole miniblocks are unpacked at once, so this is the fast way to read many elements.
+	* \param[in] first	Position of the first element to decode.
+	* \param[in] count	Number of elements to decode.
+	* \param[out] pOut	Where to write the elements. Must have room for count elements.
+	*/
+	void decode(size_type first, size_type count, integer_type* pOut) const
+	{
+		std::uint64_t aKeys[miniblock_size];
+		size_type uTailStart = m_uSize - m_vTail.size();
+		while (count)
+		{
+			size_type uTaken = 0;
+			if (first >= uTailStart)
+			{
+				uTaken = count;
+				std::copy(m_vTail.begin() + (first - uTailStart), m_vTail.begin() + (first - uTailStart) + uTaken, pOut);
+			}
+			else
+			{
+				unsigned k = layout::block_of(first);
+				size_type uOffset = static_cast<size_type>(layout::offset_of(first, k));
+				size_type uSkip = uOffset % miniblock_size;
+				uTaken = std::min(count, miniblock_size - uSkip);
+				decode_miniblock(m_vEncodedBlocks[k], uOffset / miniblock_size, aKeys);
+				for (size_type i = 0; i < uTaken; ++i)
+				{
+					pOut[i] = from_key(aKeys[uSkip + i]);
+				}
+			}
+			first += uTaken;
+			pOut += uTaken;
+			count -= uTaken;
+		}
+	}
+
+	//Modifiers
+
+	/**
+	* \brief Add an element at the end
+	* When this fills the current miniblock, the miniblock is encoded onto the end of its block.
+	* \param[in] val Value to append
+	*/
+	void push_back(integer_type val)
+	{
+		m_vTail.push_back(val);
+		++m_uSize;
+		if (m_vTail.size() == miniblock_size)
+		{
+			unsigned k = layout::block_of(m_uSize - 1);
+			if (k == m_vEncodedBlocks.size())
+			{
+				if (k)
+				{
+					//the block before is full, its last chunk no longer needs room to grow
+					m_vEncodedBlocks.back().vChunks.back().shrink_to_fit();
+				}
+				m_vEncodedBlocks.push_back(EncodedBlock{ header_vector_type(header_allocator_type(m_alloc)), chunk_vector_type(chunk_allocator_type(m_alloc)), chunk_shift(k) });
+				m_vEncodedBlocks.back().vHeaders.reserve(static_cast<size_type>(layout::block_size(k)) / miniblock_size);
+			}
+			encode_miniblock(m_vEncodedBlocks[k], k);
+			m_vTail.clear();
+		}
+	}
+
+	/**
+	* \brief Remove the last element
+	* If the uncompressed miniblock is empty the last encoded miniblock is decoded back into it first.
+	*/
+	void pop_back()
+	{
+		if (m_vTail.empty())
+		{
+			EncodedBlock& block = m_vEncodedBlocks.back();
+			std::uint64_t aKeys[miniblock_size];
+			decode_miniblock(block, block.vHeaders.size() - 1, aKeys);
+			for (size_type i = 0; i < miniblock_size; ++i)
+			{
+				m_vTail.push_back(from_key(aKeys[i]));
+			}
+			//the payload of the last miniblock runs to the end of the last chunk. Width 0 payloads take no words,
+			//so the chunk is released only if no earlier miniblock starts in it.
+			size_type uWordOffset = static_cast<size_type>(block.vHeaders.back().uWordOffset);
+			size_type uOffsetInChunk = uWordOffset & ((size_type(1) << block.uChunkShift) - 1);
+			if (uOffsetInChunk == 0 && (block.vHeaders.size() == 1 || (block.vHeaders[block.vHeaders.size() - 2].uWordOffset >> block.uChunkShift) != (uWordOffset >> block.uChunkShift)))
+			{
+				block.vChunks.pop_back();
+			}
+			else
+			{
+				block.vChunks.back().resize(uOffsetInChunk + 1);
+				block.vChunks.back().back() = 0;
+			}
+			block.vHeaders.pop_back();
+			if (block.vHeaders.empty())
+			{
+				m_vEncodedBlocks.pop_back();
+				if (!m_vEncodedBlocks.empty())
+				{
+					//the block before is the one being filled again
+					m_vEncodedBlocks.back().vChunks.back().reserve(chunk_capacity(static_cast<unsigned>(m_vEncodedBlocks.size() - 1)));
+				}
+			}
+		}
+		m_vTail.pop_back();
+		--m_uSize;
+	}
+
+	void clear() noexcept
+	{
+		m_vEncodedBlocks.clear();
+		m_vTail.clear();
+		m_uSize = 0;
+	}
+
+	void swap(CompressedBinaryVectorList& bvl) noexcept
+	{
+		m_vEncodedBlocks.swap(bvl.m_vEncodedBlocks);
+		m_vTail.swap(bvl.m_vTail);
+		std::swap(m_uSize, bvl.m_uSize);
+		std::swap(m_alloc, bvl.m_alloc);
+	}
+
+	allocator_type get_allocator() const noexcept
+	{
+		return m_alloc;
+	}
+
+protected:
+	typedef typename std::allocator_traits<allocator_type>::template rebind_alloc<std::uint64_t> word_allocator_type;
+	typedef std::vector<std::uint64_t, word_allocator_type> word_vector_type;
+	typedef std::vector<integer_type, allocator_type> tail_type;
+
+	static const std::uint8_t mode_frame_of_reference = 0;
+	static const std::uint8_t mode_delta = 1;
+
+	/**
+	* \brief How one miniblock is encoded
+	* For frame of reference the payload is value - uBase for every value.
+	* For delta uBase is the first value and the payload is the difference of every following value from the one before it.
+	* The word offset gets 48 bits, so the header stays 16 bytes while a block can hold far more than 2^32 words.
+	*/
+	struct MiniblockHeader
+	{
+		std::uint64_t uBase;
+		std::uint64_t uWordOffset : 48;
+		std::uint64_t uWidth : 8;
+		std::uint64_t uMode : 8;
+	};
+
+	typedef typename std::allocator_traits<allocator_type>::template rebind_alloc<MiniblockHeader> header_allocator_type;
+
+	typedef std::vector<MiniblockHeader, header_allocator_type> header_vector_type;
+	typedef typename std::allocator_traits<allocator_type>::template rebind_alloc<word_vector_type> chunk_allocator_type;
+	typedef std::vector<word_vector_type, chunk_allocator_type> chunk_vector_type;
+
+	/**
+	* \brief A block: one header per encoded miniblock, and the packed payloads in chunks of words.
+	* A chunk is reserved at its full capacity when it is created and a payload never straddles two chunks,
+	* so the payloads are never reallocated. Every chunk ends with a padding word.
+	* A header's word offset is the chunk index shifted left by uChunkShift plus the offset in the chunk.
+	*/
+	struct EncodedBlock
+	{
+		header_vector_type vHeaders;
+		chunk_vector_type vChunks;
+		unsigned uChunkShift;
+	};
+
+	typedef typename std::allocator_traits<allocator_type>::template rebind_alloc<EncodedBlock> encoded_block_allocator_type;
+
+	/**
+	* \brief Maps an element to an unsigned key with the same ordering (the sign bit of signed types is flipped)
+	*/
+	static std::uint64_t to_key(integer_type val) noexcept
+	{
+		if (std::is_signed<integer_type>::value)
+		{
+			return static_cast<std::uint64_t>(static_cast<std::int64_t>(val)) ^ (std::uint64_t(1) << 63);
+		}
+		return static_cast<std::uint64_t>(val);
+	}
+
+	static integer_type from_key(std::uint64_t uKey) noexcept
+	{
+		if (std::is_signed<integer_type>::value)
+		{
+			return static_cast<integer_type>(static_cast<std::int64_t>(uKey ^ (std::uint64_t(1) << 63)));
+		}
+		return static_cast<integer_type>(uKey);
+	}
+
+	/**
+	* \brief log2 of the word offsets each chunk of block k spans: 2^(k + 8) for the small blocks, whose payloads fit in one chunk, and 4096 words from block 4 on
+	*/
+	static unsigned chunk_shift(unsigned k) noexcept
+	{
+		return std::min(k + 8, 12u);
+	}
+
+	/**
+	* \brief Words reserved for a chunk of block k: no more than the block can need, every miniblock at width 64 plus a padding word
+	*/
+	static size_type chunk_capacity(unsigned k) noexcept
+	{
+		return std::min(size_type(1) << chunk_shift(k), (miniblock_size + 1) * (static_cast<size_type>(layout::block_size(k)) / miniblock_size) + 1);
+	}
+
+	/**
+	* \brief The packed payload of a miniblock of block
+	*/
+	static const std::uint64_t* payload(const EncodedBlock& block, const MiniblockHeader& header) noexcept
+	{
+		size_type uWordOffset = static_cast<size_type>(header.uWordOffset);
+		return block.vChunks[uWordOffset >> block.uChunkShift].data() + (uWordOffset & ((size_type(1) << block.uChunkShift) - 1));
+	}
+
+	/**
+	* \brief Encodes the full uncompressed miniblock onto the end of block k
+	* The payload goes into the last chunk, or a new chunk if it and the padding word do not fit.
+	*/
+	void encode_miniblock(EncodedBlock& block, unsigned k) const
+	{
+		std::uint64_t aKeys[miniblock_size];
+		bool bSorted = true;
+		std::uint64_t uMin = ~std::uint64_t(0);
+		std::uint64_t uMax = 0;
+		std::uint64_t uMaxDelta = 0;
+		for (size_type i = 0; i < miniblock_size; ++i)
+		{
+			aKeys[i] = to_key(m_vTail[i]);
+			uMin = std::min(uMin, aKeys[i]);
+			uMax = std::max(uMax, aKeys[i]);
+			if (i)
+			{
+				bSorted = bSorted && aKeys[i - 1] <= aKeys[i];
+				uMaxDelta = std::max(uMaxDelta, aKeys[i] - aKeys[i - 1]);
+			}
+		}
+		unsigned uForWidth = bvl::detail::bit_width(uMax - uMin);
+		unsigned uDeltaWidth = bvl::detail::bit_width(uMaxDelta);
+		const bool bDelta = bSorted && (miniblock_size - 1) * uDeltaWidth < miniblock_size * uForWidth;
+		size_type uPayloadWords = bDelta ? ((miniblock_size - 1) * uDeltaWidth + 63) / 64 : (miniblock_size * uForWidth + 63) / 64;
+		//the payload replaces the padding word at the end of the chunk, and is followed by a new one
+		if (block.vChunks.empty() || block.vChunks.back().size() + uPayloadWords > chunk_capacity(k))
+		{
+			block.vChunks.emplace_back(word_allocator_type(m_alloc));
+			block.vChunks.back().reserve(chunk_capacity(k));
+			block.vChunks.back().push_back(0);
+		}
+		word_vector_type& vChunk = block.vChunks.back();
+		vChunk.pop_back();
+		MiniblockHeader header;
+		header.uWordOffset = (static_cast<std::uint64_t>(block.vChunks.size() - 1) << block.uChunkShift) + vChunk.size();
+		bvl::detail::BitPacker<word_vector_type> packer(vChunk);
+		if (bDelta)
+		{
+			header.uMode = mode_delta;
+			header.uWidth = uDeltaWidth;
+			header.uBase = aKeys[0];
+			for (size_type i = 1; i < miniblock_size; ++i)
+			{
+				packer.put(aKeys[i] - aKeys[i - 1], uDeltaWidth);
+			}
+		}
+		else
+		{
+			header.uMode = mode_frame_of_reference;
+			header.uWidth = uForWidth;
+			header.uBase = uMin;
+			for (size_type i = 0; i < miniblock_size; ++i)
+			{
+				packer.put(aKeys[i] - uMin, uForWidth);
+			}
+		}
+		block.vHeaders.push_back(header);
+		//unpack_one reads 8 bytes at a time, keep it inside the chunk
+		vChunk.push_back(0);
+	}
+
+	/**
+	* \brief Unpacks the keys of miniblock m of an encoded block
+	*/
+	static void decode_miniblock(const EncodedBlock& block, size_type m, std::uint64_t* pKeys) noexcept
+	{
+		const MiniblockHeader& header = block.vHeaders[m];
+		const std::uint64_t* pWords = payload(block, header);
+		if (header.uMode == mode_frame_of_reference)
+		{
+			bvl::detail::unpack(pWords, static_cast<unsigned>(header.uWidth), miniblock_size, header.uBase, pKeys);
+		}
+		else
+		{
+			pKeys[0] = header.uBase;
+			bvl::detail::unpack(pWords, static_cast<unsigned>(header.uWidth), miniblock_size - 1, 0, pKeys + 1);
+			for (size_type i = 1; i < miniblock_size; ++i)
+			{
+				pKeys[i] += pKeys[i - 1];
+			}
+		}
+	}
+
+	std::vector<EncodedBlock, encoded_block_allocator_type> m_vEncodedBlocks;
+	tail_type m_vTail;
+	size_type m_uSize;
+	allocator_type m_alloc;
+};
+
+template<typename integer_type, typename allocator_type>
+const typename CompressedBinaryVectorList<integer_type, allocator_type>::size_type CompressedBinaryVectorList<integer_type, allocator_type>::miniblock_size;
+
+/**
+* \brief Exchange content of CompressedBinaryVectorLists
+*/
+template<typename integer_type, typename allocator_type>
+void swap(CompressedBinaryVectorList<integer_type, allocator_type>& bvlLeft, CompressedBinaryVectorList<integer_type, allocator_type>& bvlRight)
+{
+	bvlLeft.swap(bvlRight);
+}
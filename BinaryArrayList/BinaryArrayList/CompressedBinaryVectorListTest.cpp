@@ -0,0 +1,215 @@
+/** \file CompressedBinaryVectorListTest.cpp
+* \brief Round trip tests of CompressedBinaryVectorList over both encodings, full width and signed values
+* \author Taylor Dowlen
+* \copyright GNU General Public License v3.0
+* \warning THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "CompressedBinaryVectorList.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+	/**
+	* \brief Reads list back through operator[], decode(), and iterators stepped forwards and backwards
+	*/
+	template<typename integer_type>
+	bool round_trips(const CompressedBinaryVectorList<integer_type>& list, const std::vector<integer_type>& model)
+	{
+		if (list.size() != model.size())
+		{
+			return false;
+		}
+		for (std::size_t i = 0; i < model.size(); ++i)
+		{
+			if (list[i] != model[i])
+			{
+				return false;
+			}
+		}
+		//the second decode starts inside a miniblock, so its first and last miniblocks are partial
+		std::vector<integer_type> vDecoded(model.size());
+		std::size_t uHead = std::min<std::size_t>(5, model.size());
+		list.decode(0, uHead, vDecoded.data());
+		list.decode(uHead, model.size() - uHead, vDecoded.data() + uHead);
+		if (vDecoded != model || !std::equal(model.begin(), model.end(), list.begin()))
+		{
+			return false;
+		}
+		auto it = list.end();
+		for (std::size_t i = model.size(); i-- > 0;)
+		{
+			if (*--it != model[i])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	template<typename integer_type>
+	void push_both(CompressedBinaryVectorList<integer_type>& list, std::vector<integer_type>& model, integer_type val)
+	{
+		list.push_back(val);
+		model.push_back(val);
+	}
+
+	/**
+	* \brief Pops past miniblock, chunk and block boundaries, checking after each stretch, then grows back
+	*/
+	template<typename integer_type>
+	bool pops_and_regrows(CompressedBinaryVectorList<integer_type>& list, std::vector<integer_type>& model)
+	{
+		std::vector<integer_type> vRemoved;
+		bool bSame = true;
+		for (std::size_t uStretch : { std::size_t(1), std::size_t(127), std::size_t(128), std::size_t(129), std::size_t(5000) })
+		{
+			for (std::size_t i = 0; i < uStretch && !model.empty(); ++i)
+			{
+				vRemoved.push_back(model.back());
+				list.pop_back();
+				model.pop_back();
+			}
+			bSame = bSame && round_trips(list, model);
+		}
+		while (!vRemoved.empty())
+		{
+			push_both(list, model, vRemoved.back());
+			vRemoved.pop_back();
+		}
+		return bSame && round_trips(list, model);
+	}
+
+	void test_frame_of_reference()
+	{
+		std::mt19937_64 rng(13);
+		//full 64 bit values spread over the whole range, so every miniblock is packed at width 64 and the chunks fill fast
+		CompressedBinaryVectorList<std::uint64_t> wide;
+		std::vector<std::uint64_t> vWide;
+		push_both(wide, vWide, std::uint64_t(0));
+		push_both(wide, vWide, std::numeric_limits<std::uint64_t>::max());
+		for (int i = 0; i < 100000; ++i)
+		{
+			push_both(wide, vWide, static_cast<std::uint64_t>(rng()));
+		}
+		BVL_CHECK(round_trips(wide, vWide));
+		BVL_CHECK(pops_and_regrows(wide, vWide));
+
+		//narrow unsorted values around a large base
+		CompressedBinaryVectorList<std::uint64_t> narrow;
+		std::vector<std::uint64_t> vNarrow;
+		for (int i = 0; i < 50000; ++i)
+		{
+			push_both(narrow, vNarrow, std::uint64_t(1) << 40 | (rng() % 1000));
+		}
+		BVL_CHECK(round_trips(narrow, vNarrow));
+		BVL_CHECK(narrow.memory_usage() < vNarrow.size() * sizeof(std::uint64_t) / 3);
+
+		//a constant run packs at width 0
+		CompressedBinaryVectorList<std::uint64_t> constant;
+		std::vector<std::uint64_t> vConstant;
+		for (int i = 0; i < 1000; ++i)
+		{
+			push_both(constant, vConstant, std::uint64_t(42));
+		}
+		BVL_CHECK(round_trips(constant, vConstant));
+		BVL_CHECK(pops_and_regrows(constant, vConstant));
+	}
+
+	void test_delta()
+	{
+		std::mt19937_64 rng(17);
+		CompressedBinaryVectorList<std::uint64_t> list;
+		std::vector<std::uint64_t> model;
+		std::uint64_t uValue = 1700000000000000ull;
+		for (int i = 0; i < 60000; ++i)
+		{
+			uValue += rng() % 1000;
+			push_both(list, model, uValue);
+		}
+		BVL_CHECK(round_trips(list, model));
+		BVL_CHECK(list.memory_usage() < model.size() * sizeof(std::uint64_t) / 4);
+		BVL_CHECK(pops_and_regrows(list, model));
+
+		//sorted, with one jump across the whole range inside a miniblock: the deltas are 64 bits wide
+		CompressedBinaryVectorList<std::uint64_t> jump;
+		std::vector<std::uint64_t> vJump;
+		for (int i = 0; i < 300; ++i)
+		{
+			push_both(jump, vJump, i < 200 ? std::uint64_t(i) : std::numeric_limits<std::uint64_t>::max() - 300 + i);
+		}
+		BVL_CHECK(round_trips(jump, vJump));
+		BVL_CHECK(std::lower_bound(jump.begin(), jump.end(), std::uint64_t(150)) - jump.begin() == 150);
+	}
+
+	void test_signed()
+	{
+		std::mt19937_64 rng(19);
+		CompressedBinaryVectorList<std::int64_t> list;
+		std::vector<std::int64_t> model;
+		push_both(list, model, std::numeric_limits<std::int64_t>::min());
+		push_both(list, model, std::numeric_limits<std::int64_t>::max());
+		push_both(list, model, std::int64_t(-1));
+		push_both(list, model, std::int64_t(0));
+		for (int i = 0; i < 20000; ++i)
+		{
+			push_both(list, model, static_cast<std::int64_t>(rng() % 20001) - 10000);
+		}
+		//sorted negatives to positives, delta encoded across zero
+		for (std::int64_t x = -50000; x < 50000; x += 3)
+		{
+			push_both(list, model, x);
+		}
+		BVL_CHECK(round_trips(list, model));
+		BVL_CHECK(pops_and_regrows(list, model));
+
+		CompressedBinaryVectorList<std::int8_t> small;
+		std::vector<std::int8_t> vSmall;
+		for (int i = 0; i < 3000; ++i)
+		{
+			push_both(small, vSmall, static_cast<std::int8_t>(static_cast<int>(rng() % 256) - 128));
+		}
+		BVL_CHECK(round_trips(small, vSmall));
+		BVL_CHECK(pops_and_regrows(small, vSmall));
+	}
+
+	void test_clear_and_swap()
+	{
+		CompressedBinaryVectorList<std::uint32_t> a;
+		CompressedBinaryVectorList<std::uint32_t> b;
+		std::vector<std::uint32_t> vA;
+		for (std::uint32_t i = 0; i < 5000; ++i)
+		{
+			push_both(a, vA, i * 7);
+		}
+		swap(a, b);
+		BVL_CHECK(a.empty() && round_trips(b, vA));
+		b.clear();
+		BVL_CHECK(b.empty() && b.memory_usage() <= CompressedBinaryVectorList<std::uint32_t>::miniblock_size * sizeof(std::uint32_t));
+		vA.clear();
+		for (std::uint32_t i = 0; i < 700; ++i)
+		{
+			push_both(b, vA, i);
+		}
+		BVL_CHECK(round_trips(b, vA));
+	}
+}
+
+void bvl::test::run_compressed_tests()
+{
+	test_frame_of_reference();
+	test_delta();
+	test_signed();
+	test_clear_and_swap();
+}
@@ -0,0 +1,407 @@
+/** \file PriorityQueue.h
+* \brief bvl::priority_queue Header File
+* \author Taylor Dowlen
+* \copyright GNU General Public License v3.0
+* \warning THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "BinaryVectorList.h"
+
+namespace bvl
+{
+	/**
+	* \brief A binary heap stored in doubling blocks, one block per level.
+	* Level k of a binary heap has 2^k nodes, so with blocks that start at one element (bvl::detail::BlockLayout<0>)
+	* level k is exactly block k, and each level is one array. The children of node o of level k are nodes 2o and 2o + 1
+	* of level k + 1, and its parent is node o / 2 of level k - 1, so sifting follows one block pointer per level
+	* and never works out a block from a position.
+	* A level is allocated when the one before it is full and is never reallocated, so elements never move to make room
+	* and push has no reallocation spike. The first first_levels levels (15 elements) share one allocation.
+	* The interface is that of std::priority_queue: top() is the greatest element by comp.
+	* \tparam element_type		The type of elements in the queue.
+	* \tparam Compare			Strict weak ordering, the greatest element comes out first.
+	* \tparam allocator_type	The type of allocator used for the levels.
+	*/
+	template<typename element_type, typename Compare = std::less<element_type>, typename allocator_type = std::allocator<element_type> >
+	class priority_queue
+	{
+	public:
+		//Typedefs
+
+		typedef element_type value_type;
+		typedef value_type& reference;
+		typedef const value_type& const_reference;
+		typedef Compare value_compare;
+		typedef typename std::allocator_traits<allocator_type>::pointer pointer;
+		typedef typename std::allocator_traits<allocator_type>::size_type size_type;
+
+		/**
+		* Level k of the heap is block k, which holds 2^k elements
+		*/
+		typedef bvl::detail::BlockLayout<0> layout;
+
+		/**
+		* Number of levels that share the first allocation
+		*/
+		static const unsigned first_levels = 4;
+
+		//Constructors
+
+		/**
+		* \brief Empty Queue Constructor
+		* \param[in] comp	Ordering of the elements.
+		* \param[in] alloc	Allocator to use for the levels.
+		*/
+		explicit priority_queue(const Compare& comp = Compare(), const allocator_type& alloc = allocator_type())
+			: m_apLevels(), m_uLevels(0), m_uSize(0), m_comp(comp), m_alloc(alloc)
+		{
+		}
+
+		/**
+		* \brief Range Constructor
+		* Appends the elements of [first, last) and then builds the heap bottom up, in linear time.
+		*/
+		template<typename InputIterator, typename = typename std::iterator_traits<InputIterator>::iterator_category>
+		priority_queue(InputIterator first, InputIterator last, const Compare& comp = Compare(), const allocator_type& alloc = allocator_type())
+			: m_apLevels(), m_uLevels(0), m_uSize(0), m_comp(comp), m_alloc(alloc)
+		{
+			try
+			{
+				for (; first != last; ++first)
+				{
+					append(*first);
+				}
+				for (size_type p = m_uSize / 2; p-- > 0; )
+				{
+					unsigned uLevel = layout::block_of(p);
+					size_type uOffset = static_cast<size_type>(layout::offset_of(p, uLevel));
+					value_type val(std::move(*slot(uLevel, uOffset)));
+					sift_down(uLevel, uOffset, std::move(val));
+				}
+			}
+			catch (...)
+			{
+				clear();
+				release_levels();
+				throw;
+			}
+		}
+
+		/**
+		* \brief Copy Constructor
+		* Copies every level as it is, so the copy is already a heap.
+		*/
+		priority_queue(const priority_queue& pq)
+			: m_apLevels(), m_uLevels(0), m_uSize(0), m_comp(pq.m_comp),
+			m_alloc(std::allocator_traits<allocator_type>::select_on_container_copy_construction(pq.m_alloc))
+		{
+			copy_elements(pq);
+		}
+
+		/**
+		* \brief Move Constructor
+		* Takes the levels of pq, pq is left empty.
+		*/
+		priority_queue(priority_queue&& pq) noexcept
+			: m_apLevels(), m_uLevels(0), m_uSize(0), m_comp(pq.m_comp), m_alloc(pq.m_alloc)
+		{
+			swap(pq);
+		}
+
+		//Destructor
+
+		~priority_queue()
+		{
+			clear();
+			release_levels();
+		}
+
+		//Assignment Operators
+
+		priority_queue& operator= (const priority_queue& pq)
+		{
+			if (this != &pq)
+			{
+				clear();
+				m_comp = pq.m_comp;
+				copy_elements(pq);
+			}
+			return *this;
+		}
+
+		priority_queue& operator= (priority_queue&& pq) noexcept
+		{
+			if (this != &pq)
+			{
+				clear();
+				swap(pq);
+			}
+			return *this;
+		}
+
+		//Capacity
+
+		bool empty() const noexcept
+		{
+			return m_uSize == 0;
+		}
+
+		size_type size() const noexcept
+		{
+			return m_uSize;
+		}
+
+		/**
+		* \brief Elements that fit in the levels allocated so far
+		*/
+		size_type capacity() const noexcept
+		{
+			return static_cast<size_type>(layout::block_start(m_uLevels));
+		}
+
+		/**
+		* \brief Allocates the levels needed to hold n elements. No element moves.
+		*/
+		void reserve(size_type n)
+		{
+			while (capacity() < n)
+			{
+				add_level();
+			}
+		}
+
+		//Element Access
+
+		/**
+		* \brief The greatest element. The queue must not be empty.
+		*/
+		const_reference top() const
+		{
+			BVL_HARDENED_CHECK(m_uSize != 0, "top() of an empty priority_queue");
+			return m_apLevels[0][0];
+		}
+
+		//Modifiers
+
+		void push(const value_type& val)
+		{
+			emplace(val);
+		}
+
+		void push(value_type&& val)
+		{
+			emplace(std::move(val));
+		}
+
+		/**
+		* \brief Constructs an element at the end of the last level and sifts it up, one level at a time
+		*/
+		template<typename... Args>
+		void emplace(Args&&... args)
+		{
+			append(std::forward<Args>(args)...);
+			unsigned uLevel = layout::block_of(m_uSize - 1);
+			size_type uOffset = static_cast<size_type>(layout::offset_of(m_uSize - 1, uLevel));
+			value_type val(std::move(*slot(uLevel, uOffset)));
+			for (; uLevel != 0; --uLevel, uOffset /= 2)
+			{
+				value_type* pParent = slot(uLevel - 1, uOffset / 2);
+				if (!m_comp(*pParent, val))
+				{
+					break;
+				}
+				*slot(uLevel, uOffset) = std::move(*pParent);
+			}
+			*slot(uLevel, uOffset) = std::move(val);
+		}
+
+		/**
+		* \brief Removes the greatest element. The last element takes its place and sifts down, one level at a time.
+		* The levels stay allocated.
+		*/
+		void pop()
+		{
+			BVL_HARDENED_CHECK(m_uSize != 0, "pop() of an empty priority_queue");
+			--m_uSize;
+			unsigned uLevel = layout::block_of(m_uSize);
+			value_type* pLast = slot(uLevel, static_cast<size_type>(layout::offset_of(m_uSize, uLevel)));
+			if (m_uSize == 0)
+			{
+				std::allocator_traits<allocator_type>::destroy(m_alloc, pLast);
+				return;
+			}
+			value_type val(std::move(*pLast));
+			std::allocator_traits<allocator_type>::destroy(m_alloc, pLast);
+			sift_down(0, 0, std::move(val));
+		}
+
+		/**
+		* \brief Destroys every element. The levels stay allocated.
+		*/
+		void clear() noexcept
+		{
+			for (size_type p = 0; p < m_uSize; ++p)
+			{
+				unsigned uLevel = layout::block_of(p);
+				std::allocator_traits<allocator_type>::destroy(m_alloc, slot(uLevel, static_cast<size_type>(layout::offset_of(p, uLevel))));
+			}
+			m_uSize = 0;
+		}
+
+		void swap(priority_queue& pq) noexcept
+		{
+			std::swap(m_apLevels, pq.m_apLevels);
+			std::swap(m_uLevels, pq.m_uLevels);
+			std::swap(m_uSize, pq.m_uSize);
+			std::swap(m_comp, pq.m_comp);
+			std::swap(m_alloc, pq.m_alloc);
+		}
+
+		allocator_type get_allocator() const noexcept
+		{
+			return m_alloc;
+		}
+
+	protected:
+		/**
+		* \brief Address of node uOffset of level uLevel
+		*/
+		value_type* slot(unsigned uLevel, size_type uOffset) const noexcept
+		{
+			return std::addressof(m_apLevels[uLevel][uOffset]);
+		}
+
+		/**
+		* \brief Constructs an element after the last one, without restoring the heap order
+		*/
+		template<typename... Args>
+		void append(Args&&... args)
+		{
+			if (m_uSize == capacity())
+			{
+				//The arguments may refer to an element, and adding a level moves none
+				add_level();
+			}
+			unsigned uLevel = layout::block_of(m_uSize);
+			std::allocator_traits<allocator_type>::construct(m_alloc, slot(uLevel, static_cast<size_type>(layout::offset_of(m_uSize, uLevel))), std::forward<Args>(args)...);
+			++m_uSize;
+		}
+
+		/**
+		* \brief Places val in the subtree under node uOffset of level uLevel, whose own element has been moved out.
+		* The larger child moves up into the hole until val is not less than it.
+		*/
+		void sift_down(unsigned uLevel, size_type uOffset, value_type&& val)
+		{
+			for (;;)
+			{
+				size_type uChild = 2 * uOffset;
+				size_type uChildPosition = static_cast<size_type>(layout::block_start(uLevel + 1)) + uChild;
+				if (uChildPosition >= m_uSize)
+				{
+					break;
+				}
+				value_type* pChild = slot(uLevel + 1, uChild);
+				if (uChildPosition + 1 < m_uSize && m_comp(pChild[0], pChild[1]))
+				{
+					++uChild;
+					++pChild;
+				}
+				if (!m_comp(val, *pChild))
+				{
+					break;
+				}
+				*slot(uLevel, uOffset) = std::move(*pChild);
+				++uLevel;
+				uOffset = uChild;
+			}
+			*slot(uLevel, uOffset) = std::move(val);
+		}
+
+		/**
+		* \brief Copy constructs the elements of pq at the same positions. If a copy throws, the queue is left empty with no levels.
+		*/
+		void copy_elements(const priority_queue& pq)
+		{
+			reserve(pq.m_uSize);
+			try
+			{
+				for (unsigned uLevel = 0; static_cast<size_type>(layout::block_start(uLevel)) < pq.m_uSize; ++uLevel)
+				{
+					size_type uCount = std::min(static_cast<size_type>(layout::block_size(uLevel)), pq.m_uSize - static_cast<size_type>(layout::block_start(uLevel)));
+					for (size_type i = 0; i < uCount; ++i)
+					{
+						std::allocator_traits<allocator_type>::construct(m_alloc, slot(uLevel, i), *pq.slot(uLevel, i));
+						++m_uSize;
+					}
+				}
+			}
+			catch (...)
+			{
+				clear();
+				release_levels();
+				throw;
+			}
+		}
+
+		/**
+		* \brief Allocates the next level, or the first first_levels levels together
+		*/
+		void add_level()
+		{
+			if (m_uLevels == layout::max_blocks)
+			{
+				throw std::length_error("priority_queue::add_level");
+			}
+			if (m_uLevels == 0)
+			{
+				pointer pFirst = std::allocator_traits<allocator_type>::allocate(m_alloc, static_cast<size_type>(layout::block_start(first_levels)));
+				for (unsigned uLevel = 0; uLevel < first_levels; ++uLevel)
+				{
+					m_apLevels[uLevel] = pFirst + static_cast<std::ptrdiff_t>(layout::block_start(uLevel));
+				}
+				m_uLevels = first_levels;
+				return;
+			}
+			m_apLevels[m_uLevels] = std::allocator_traits<allocator_type>::allocate(m_alloc, static_cast<size_type>(layout::block_size(m_uLevels)));
+			++m_uLevels;
+		}
+
+		/**
+		* \brief Deallocates every level. They must not hold any elements.
+		*/
+		void release_levels() noexcept
+		{
+			for (; m_uLevels > first_levels; --m_uLevels)
+			{
+				std::allocator_traits<allocator_type>::deallocate(m_alloc, m_apLevels[m_uLevels - 1], static_cast<size_type>(layout::block_size(m_uLevels - 1)));
+			}
+			if (m_uLevels)
+			{
+				std::allocator_traits<allocator_type>::deallocate(m_alloc, m_apLevels[0], static_cast<size_type>(layout::block_start(first_levels)));
+			}
+			std::fill(m_apLevels, m_apLevels + layout::max_blocks, pointer());
+			m_uLevels = 0;
+		}
+
+		pointer m_apLevels[layout::max_blocks];
+		unsigned m_uLevels;
+		size_type m_uSize;
+		Compare m_comp;
+		allocator_type m_alloc;
+	};
+
+	template<typename element_type, typename Compare, typename allocator_type>
+	void swap(priority_queue<element_type, Compare, allocator_type>& lhs, priority_queue<element_type, Compare, allocator_type>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+}
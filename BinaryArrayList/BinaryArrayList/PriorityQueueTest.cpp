@@ -0,0 +1,258 @@
+/** \file PriorityQueueTest.cpp
+* \brief Tests of bvl::priority_queue against std::priority_queue: heapify, custom orderings, copies and level growth
+* \author Taylor Dowlen
+* \copyright GNU General Public License v3.0
+* \warning THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "PriorityQueue.h"
+#include "TestCheck.h"
+
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	/**
+	* \brief Orders numbers by their remainder, so the queue has to keep the state of its comparison (and its ties)
+	*/
+	struct ByRemainder
+	{
+		explicit ByRemainder(unsigned uModulus = 1) : m_uModulus(uModulus) {}
+
+		bool operator()(unsigned a, unsigned b) const
+		{
+			return a % m_uModulus < b % m_uModulus;
+		}
+
+		unsigned m_uModulus;
+	};
+
+	/**
+	* \brief A string outside the small string buffer, so a lost or doubled element shows up under the sanitizers
+	*/
+	std::string long_string(unsigned uValue)
+	{
+		return std::to_string(uValue) + " is a value that needs a heap allocation";
+	}
+
+	/**
+	* \brief Pops both until they are empty. The tops are compared by key, since equal keys may come out in either order.
+	*/
+	template<typename queue_type, typename model_type, typename KeyFunction>
+	bool drains_same(queue_type& pq, model_type& model, KeyFunction key)
+	{
+		while (!model.empty())
+		{
+			if (pq.size() != model.size() || key(pq.top()) != key(model.top()))
+			{
+				return false;
+			}
+			pq.pop();
+			model.pop();
+		}
+		return pq.empty();
+	}
+
+	template<typename queue_type, typename model_type>
+	bool drains_same(queue_type& pq, model_type& model)
+	{
+		return drains_same(pq, model, [](const typename model_type::value_type& val) { return val; });
+	}
+
+	void test_push_pop()
+	{
+		std::mt19937_64 rng(31);
+		bvl::priority_queue<unsigned> pq;
+		std::priority_queue<unsigned> model;
+		BVL_CHECK(pq.capacity() == 0);
+
+		//the first four levels come in one allocation, and the fifth level is the first one added on its own
+		for (unsigned i = 0; i < 15; ++i)
+		{
+			pq.push(i * 7 % 15);
+			model.push(i * 7 % 15);
+		}
+		BVL_CHECK(pq.capacity() == 15 && pq.top() == model.top());
+		pq.push(100);
+		model.push(100);
+		BVL_CHECK(pq.capacity() == 31 && pq.top() == 100);
+
+		//pushes and pops interleaved over several new levels, with the size crossing level boundaries both ways
+		bool bSame = true;
+		for (int i = 0; i < 20000; ++i)
+		{
+			if (rng() % 3 == 0 && !model.empty())
+			{
+				pq.pop();
+				model.pop();
+			}
+			else
+			{
+				unsigned uValue = static_cast<unsigned>(rng() % 5000);
+				pq.emplace(uValue);
+				model.push(uValue);
+			}
+			bSame = bSame && pq.size() == model.size() && (model.empty() || pq.top() == model.top());
+		}
+		BVL_CHECK(bSame);
+		bvl::priority_queue<unsigned>::size_type uCapacity = pq.capacity();
+		BVL_CHECK(drains_same(pq, model));
+
+		//popping keeps the levels, so pushing again allocates nothing
+		BVL_CHECK(pq.capacity() == uCapacity);
+		for (unsigned i = 0; i < uCapacity; ++i)
+		{
+			pq.push(i);
+			model.push(i);
+		}
+		BVL_CHECK(pq.capacity() == uCapacity);
+		BVL_CHECK(drains_same(pq, model));
+
+		bvl::priority_queue<unsigned> reserved;
+		reserved.reserve(1000);
+		uCapacity = reserved.capacity();
+		for (unsigned i = 0; i < 1000; ++i)
+		{
+			reserved.push(i);
+		}
+		BVL_CHECK(uCapacity >= 1000 && reserved.capacity() == uCapacity && reserved.top() == 999);
+	}
+
+	void test_range_constructor()
+	{
+		std::mt19937_64 rng(37);
+		//sizes around the first levels and their shared allocation, and ones whose last level is partly filled
+		for (std::size_t uCount : { std::size_t(0), std::size_t(1), std::size_t(2), std::size_t(14), std::size_t(15), std::size_t(16),
+			std::size_t(17), std::size_t(31), std::size_t(32), std::size_t(1000), std::size_t(4097) })
+		{
+			std::vector<unsigned> vValues;
+			for (std::size_t i = 0; i < uCount; ++i)
+			{
+				vValues.push_back(static_cast<unsigned>(rng() % 300));
+			}
+			bvl::priority_queue<unsigned> pq(vValues.begin(), vValues.end());
+			std::priority_queue<unsigned> model(vValues.begin(), vValues.end());
+			BVL_CHECK(pq.size() == uCount && pq.capacity() >= uCount);
+			BVL_CHECK(drains_same(pq, model));
+
+			//a min-heap of strings, moved in from the range
+			std::vector<std::string> vStrings;
+			for (unsigned uValue : vValues)
+			{
+				vStrings.push_back(long_string(uValue));
+			}
+			bvl::priority_queue<std::string, std::greater<std::string> > strings(std::make_move_iterator(vStrings.begin()), std::make_move_iterator(vStrings.end()));
+			std::priority_queue<std::string, std::vector<std::string>, std::greater<std::string> > stringModel;
+			for (unsigned uValue : vValues)
+			{
+				stringModel.push(long_string(uValue));
+			}
+			BVL_CHECK(drains_same(strings, stringModel));
+		}
+	}
+
+	void test_custom_compare()
+	{
+		std::mt19937_64 rng(41);
+		ByRemainder byRemainder(10);
+		std::vector<unsigned> vValues;
+		for (int i = 0; i < 3000; ++i)
+		{
+			vValues.push_back(static_cast<unsigned>(rng() % 100000));
+		}
+		bvl::priority_queue<unsigned, ByRemainder> pq(vValues.begin(), vValues.end(), byRemainder);
+		std::priority_queue<unsigned, std::vector<unsigned>, ByRemainder> model(vValues.begin(), vValues.end(), byRemainder);
+		auto remainder = [](unsigned uValue) { return uValue % 10; };
+
+		//copies and moves carry the comparison's state
+		bvl::priority_queue<unsigned, ByRemainder> copy(pq);
+		std::priority_queue<unsigned, std::vector<unsigned>, ByRemainder> copyModel(model);
+		bvl::priority_queue<unsigned, ByRemainder> assigned;
+		assigned = pq;
+		std::priority_queue<unsigned, std::vector<unsigned>, ByRemainder> assignedModel(model);
+		bvl::priority_queue<unsigned, ByRemainder> moved(std::move(pq));
+		BVL_CHECK(pq.empty());
+		BVL_CHECK(drains_same(moved, model, remainder));
+		BVL_CHECK(drains_same(copy, copyModel, remainder));
+		BVL_CHECK(drains_same(assigned, assignedModel, remainder));
+
+		bvl::priority_queue<unsigned, std::greater<unsigned> > minimum;
+		std::priority_queue<unsigned, std::vector<unsigned>, std::greater<unsigned> > minimumModel;
+		bool bSame = true;
+		for (unsigned uValue : vValues)
+		{
+			minimum.push(uValue);
+			minimumModel.push(uValue);
+			bSame = bSame && minimum.top() == minimumModel.top();
+		}
+		BVL_CHECK(bSame);
+		BVL_CHECK(drains_same(minimum, minimumModel));
+	}
+
+	void test_copy()
+	{
+		bvl::priority_queue<std::string> pq;
+		std::priority_queue<std::string> model;
+		for (unsigned i = 0; i < 100; ++i)
+		{
+			pq.push(long_string(i * 37 % 100));
+			model.push(long_string(i * 37 % 100));
+		}
+
+		//draining the copy leaves the original as it was
+		bvl::priority_queue<std::string> copy(pq);
+		std::priority_queue<std::string> copyModel(model);
+		BVL_CHECK(drains_same(copy, copyModel));
+		BVL_CHECK(pq.size() == 100 && pq.top() == model.top());
+
+		//assigning over a larger queue, and a queue to itself
+		bvl::priority_queue<std::string> assigned;
+		for (unsigned i = 0; i < 500; ++i)
+		{
+			assigned.push(long_string(i));
+		}
+		assigned = pq;
+		bvl::priority_queue<std::string>& self = assigned;
+		assigned = self;
+		std::priority_queue<std::string> assignedModel(model);
+		BVL_CHECK(drains_same(assigned, assignedModel));
+
+		//an empty copy, then a copy that grows past the levels it was copied with
+		bvl::priority_queue<std::string> empty;
+		bvl::priority_queue<std::string> emptyCopy(empty);
+		BVL_CHECK(emptyCopy.empty() && emptyCopy.capacity() == 0);
+		bvl::priority_queue<std::string> grown(pq);
+		std::priority_queue<std::string> grownModel(model);
+		for (unsigned i = 100; i < 1000; ++i)
+		{
+			grown.push(long_string(i));
+			grownModel.push(long_string(i));
+		}
+		BVL_CHECK(drains_same(grown, grownModel));
+
+		bvl::priority_queue<std::string> other;
+		other.push(long_string(1));
+		swap(other, pq);
+		BVL_CHECK(pq.size() == 1 && other.size() == 100);
+		BVL_CHECK(drains_same(other, model));
+	}
+}
+
+void bvl::test::run_priority_queue_tests()
+{
+	test_push_pop();
+	test_range_constructor();
+	test_custom_compare();
+	test_copy();
+}
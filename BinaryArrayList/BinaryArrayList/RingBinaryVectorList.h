@@ -0,0 +1,508 @@
+/** \file RingBinaryVectorList.h
+* \brief RingBinaryVectorList Header File
+* \author Taylor Dowlen
+* \copyright GNU General Public License v3.0
+* \warning THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "BinaryVectorList.h"
+
+/**
+* \brief A sliding window over the doubling blocks of BinaryVectorList.
+* The blocks form a ring: the front element is at physical position m_uHead, and position n is at m_uHead + n,
+* wrapped around the capacity. pop_front, and push_back into a full window, only destroy the front element and move m_uHead,
+* so evicting the oldest element is constant time and the slots it leaves behind are reused at the back instead of freed.
+* Until the window is reached the ring grows one doubling block at a time like a BinaryVectorList. Blocks are never freed
+* or reallocated before the list is destroyed, so after warming up it makes no more allocations.
+* When a block is added while the contents wrap around, the wrapped part (less than the old capacity) is moved into the new block,
+* which keeps the ring in order. That is the only time elements move.
+* \tparam element_type		The type of elements in the list.
+* \tparam allocator_type	The type of allocator used for the blocks.
+*/
+template<typename element_type, typename allocator_type = std::allocator<element_type> >
+class RingBinaryVectorList
+{
+public:
+	//Typedefs
+
+	typedef element_type value_type;
+	typedef value_type& reference;
+	typedef const value_type& const_reference;
+	typedef typename std::allocator_traits<allocator_type>::pointer pointer;
+	typedef typename std::allocator_traits<allocator_type>::const_pointer const_pointer;
+	typedef bvl::BinaryVectorListIndexIterator<RingBinaryVectorList, value_type&> iterator;
+	typedef bvl::BinaryVectorListIndexIterator<const RingBinaryVectorList, const value_type&> const_iterator;
+	typedef std::reverse_iterator<iterator> reverse_iterator;
+	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+	typedef typename std::allocator_traits<allocator_type>::difference_type difference_type;
+	typedef typename std::allocator_traits<allocator_type>::size_type size_type;
+
+	/**
+	* The block size progression, the same as BinaryVectorList's. Block 0 holds 16 elements.
+	*/
+	typedef bvl::detail::BlockLayout<4> layout;
+
+	//Constructors
+
+	/**
+	* \brief Empty Container Constructor
+	* \param[in] uWindow	Most elements kept. Pushing past it evicts the front element. 0 keeps every element.
+	* \param[in] alloc		Allocator to use for the blocks.
+	*/
+	explicit RingBinaryVectorList(size_type uWindow = 0, const allocator_type& alloc = allocator_type())
+		: m_apBlocks(), m_uBlocks(0), m_uCapacity(0), m_uHead(0), m_uSize(0), m_uWindow(uWindow), m_alloc(alloc)
+	{
+	}
+
+	/**
+	* \brief Copy Constructor
+	* The copy has the same window and elements, starting at physical position 0.
+	*/
+	RingBinaryVectorList(const RingBinaryVectorList& rbvl)
+		: m_apBlocks(), m_uBlocks(0), m_uCapacity(0), m_uHead(0), m_uSize(0), m_uWindow(rbvl.m_uWindow),
+		m_alloc(std::allocator_traits<allocator_type>::select_on_container_copy_construction(rbvl.m_alloc))
+	{
+		reserve(rbvl.size());
+		for (const value_type& val : rbvl)
+		{
+			push_back(val);
+		}
+	}
+
+	/**
+	* \brief Move Constructor
+	* Takes the blocks of rbvl, rbvl is left empty.
+	*/
+	RingBinaryVectorList(RingBinaryVectorList&& rbvl) noexcept
+		: m_apBlocks(), m_uBlocks(0), m_uCapacity(0), m_uHead(0), m_uSize(0), m_uWindow(0), m_alloc(rbvl.m_alloc)
+	{
+		swap(rbvl);
+	}
+
+	//Destructor
+
+	~RingBinaryVectorList()
+	{
+		clear();
+		for (unsigned k = 0; k < m_uBlocks; ++k)
+		{
+			std::allocator_traits<allocator_type>::deallocate(m_alloc, m_apBlocks[k], static_cast<size_type>(layout::block_size(k)));
+		}
+	}
+
+	//Assignment Operators
+
+	RingBinaryVectorList& operator= (const RingBinaryVectorList& rbvl)
+	{
+		if (this != &rbvl)
+		{
+			clear();
+			m_uWindow = rbvl.m_uWindow;
+			reserve(rbvl.size());
+			for (const value_type& val : rbvl)
+			{
+				push_back(val);
+			}
+		}
+		return *this;
+	}
+
+	RingBinaryVectorList& operator= (RingBinaryVectorList&& rbvl) noexcept
+	{
+		if (this != &rbvl)
+		{
+			clear();
+			swap(rbvl);
+		}
+		return *this;
+	}
+
+	//Iterators
+
+	iterator begin() noexcept { return iterator(this, 0); }
+	const_iterator begin() const noexcept { return const_iterator(this, 0); }
+	iterator end() noexcept { return iterator(this, m_uSize); }
+	const_iterator end() const noexcept { return const_iterator(this, m_uSize); }
+	reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+	const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+	reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+	const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+	const_iterator cbegin() const noexcept { return begin(); }
+	const_iterator cend() const noexcept { return end(); }
+
+	//Capacity
+
+	size_type size() const noexcept
+	{
+		return m_uSize;
+	}
+
+	bool empty() const noexcept
+	{
+		return m_uSize == 0;
+	}
+
+	/**
+	* \brief Whether the list holds window() elements, so that the next push_back evicts the front element
+	*/
+	bool full() const noexcept
+	{
+		return m_uWindow != 0 && m_uSize == m_uWindow;
+	}
+
+	/**
+	* \brief Most elements kept, 0 if the list is unbounded
+	*/
+	size_type window() const noexcept
+	{
+		return m_uWindow;
+	}
+
+	/**
+	* \brief Change the most elements kept. Evicts front elements if there are more than uWindow.
+	* The blocks already allocated are kept.
+	* \param[in] uWindow Most elements kept, 0 to keep every element.
+	*/
+	void set_window(size_type uWindow)
+	{
+		m_uWindow = uWindow;
+		while (m_uWindow != 0 && m_uSize > m_uWindow)
+		{
+			pop_front();
+		}
+	}
+
+	size_type max_size() const noexcept
+	{
+		return static_cast<size_type>(std::min<std::uint64_t>(std::allocator_traits<allocator_type>::max_size(m_alloc), layout::block_start(layout::max_blocks)));
+	}
+
+	/**
+	* \brief Elements that fit in the blocks allocated so far
+	*/
+	size_type capacity() const noexcept
+	{
+		return m_uCapacity;
+	}
+
+	/**
+	* \brief Allocates the blocks needed to hold n elements
+	* \throw std::length_error if n is more than max_size()
+	*/
+	void reserve(size_type n)
+	{
+		if (n > max_size())
+		{
+			throw std::length_error("RingBinaryVectorList::reserve");
+		}
+		while (m_uCapacity < n)
+		{
+			add_block();
+		}
+	}
+
+	//Element Access
+
+	/**
+	* \brief Access element. n must be less than size().
+	*/
+	reference operator[] (size_type n)
+	{
+		BVL_HARDENED_CHECK(n < m_uSize, "operator[] past the end");
+		return *slot(physical(n));
+	}
+
+	/**
+	* \brief Access element. n must be less than size().
+	*/
+	const_reference operator[] (size_type n) const
+	{
+		BVL_HARDENED_CHECK(n < m_uSize, "operator[] past the end");
+		return *slot(physical(n));
+	}
+
+	/**
+	* \brief Access element
+	* \throw std::out_of_range if n is not less than size()
+	*/
+	reference at(size_type n)
+	{
+		if (n >= m_uSize)
+		{
+			throw std::out_of_range("RingBinaryVectorList::at");
+		}
+		return (*this)[n];
+	}
+
+	/**
+	* \brief Access element
+	* \throw std::out_of_range if n is not less than size()
+	*/
+	const_reference at(size_type n) const
+	{
+		if (n >= m_uSize)
+		{
+			throw std::out_of_range("RingBinaryVectorList::at");
+		}
+		return (*this)[n];
+	}
+
+	reference front() { return (*this)[0]; }
+	const_reference front() const { return (*this)[0]; }
+	reference back() { return (*this)[m_uSize - 1]; }
+	const_reference back() const { return (*this)[m_uSize - 1]; }
+
+	//Modifiers
+
+	void push_back(const value_type& val)
+	{
+		emplace_back(val);
+	}
+
+	void push_back(value_type&& val)
+	{
+		emplace_back(std::move(val));
+	}
+
+	/**
+	* \brief Construct an element at the end
+	* If the window is full the front element is evicted first, and the new element takes the slot after the back.
+	*/
+	template<typename... Args>
+	void emplace_back(Args&&... args)
+	{
+		if (full() || m_uSize == m_uCapacity)
+		{
+			//The value is made first, since the arguments may refer to the evicted element or to the wrapped elements that add_block moves
+			value_type tmp(std::forward<Args>(args)...);
+			if (full())
+			{
+				pop_front();
+			}
+			else
+			{
+				add_block();
+			}
+			std::allocator_traits<allocator_type>::construct(m_alloc, slot(physical(m_uSize)), std::move(tmp));
+			++m_uSize;
+			return;
+		}
+		std::allocator_traits<allocator_type>::construct(m_alloc, slot(physical(m_uSize)), std::forward<Args>(args)...);
+		++m_uSize;
+	}
+
+	/**
+	* \brief Remove the front element. Its slot is reused by a later push_back.
+	*/
+	void pop_front()
+	{
+		BVL_HARDENED_CHECK(m_uSize != 0, "pop_front() of an empty list");
+		std::allocator_traits<allocator_type>::destroy(m_alloc, slot(m_uHead));
+		m_uHead = --m_uSize ? physical(1) : 0;
+	}
+
+	void pop_back()
+	{
+		BVL_HARDENED_CHECK(m_uSize != 0, "pop_back() of an empty list");
+		--m_uSize;
+		std::allocator_traits<allocator_type>::destroy(m_alloc, slot(physical(m_uSize)));
+		if (m_uSize == 0)
+		{
+			m_uHead = 0;
+		}
+	}
+
+	/**
+	* \brief Removes the first n elements and moves them to out, in order. No other element moves.
+	* Each run of the ring inside one block is moved with std::move on plain pointers.
+	* \param[in] n		Number of elements to remove, at most size()
+	* \param[in] out	Where to move the first element, for example a pointer into a span or a back_insert_iterator
+	* \return out past the last moved element
+	*/
+	template<typename OutputIterator>
+	OutputIterator pop_front_n(size_type n, OutputIterator out)
+	{
+		BVL_HARDENED_CHECK(n <= m_uSize, "pop_front_n() past the end");
+		out = move_range(0, n, out);
+		destroy_range(0, n);
+		size_type uHead = physical(n);
+		m_uSize -= n;
+		m_uHead = m_uSize ? uHead : 0;
+		return out;
+	}
+
+	/**
+	* \brief Removes the last n elements and moves them to out, in order
+	* \param[in] n		Number of elements to remove, at most size()
+	* \param[in] out	Where to move the first of the last n elements
+	* \return out past the last moved element
+	*/
+	template<typename OutputIterator>
+	OutputIterator pop_back_n(size_type n, OutputIterator out)
+	{
+		BVL_HARDENED_CHECK(n <= m_uSize, "pop_back_n() past the end");
+		out = move_range(m_uSize - n, m_uSize, out);
+		destroy_range(m_uSize - n, m_uSize);
+		m_uSize -= n;
+		if (m_uSize == 0)
+		{
+			m_uHead = 0;
+		}
+		return out;
+	}
+
+	/**
+	* \brief Destroys every element. The blocks stay allocated.
+	*/
+	void clear() noexcept
+	{
+		for (size_type i = 0; i < m_uSize; ++i)
+		{
+			std::allocator_traits<allocator_type>::destroy(m_alloc, slot(physical(i)));
+		}
+		m_uHead = 0;
+		m_uSize = 0;
+	}
+
+	void swap(RingBinaryVectorList& rbvl) noexcept
+	{
+		std::swap(m_apBlocks, rbvl.m_apBlocks);
+		std::swap(m_uBlocks, rbvl.m_uBlocks);
+		std::swap(m_uCapacity, rbvl.m_uCapacity);
+		std::swap(m_uHead, rbvl.m_uHead);
+		std::swap(m_uSize, rbvl.m_uSize);
+		std::swap(m_uWindow, rbvl.m_uWindow);
+		std::swap(m_alloc, rbvl.m_alloc);
+	}
+
+	allocator_type get_allocator() const noexcept
+	{
+		return m_alloc;
+	}
+
+protected:
+	/**
+	* \brief Physical position of element n, which may be up to one capacity past the end of the blocks before wrapping
+	*/
+	size_type physical(size_type n) const noexcept
+	{
+		size_type p = m_uHead + n;
+		return p >= m_uCapacity ? p - m_uCapacity : p;
+	}
+
+	/**
+	* \brief Address of physical position p
+	*/
+	value_type* slot(size_type p) const noexcept
+	{
+		unsigned k = layout::block_of(p);
+		return std::addressof(m_apBlocks[k][static_cast<size_type>(layout::offset_of(p, k))]);
+	}
+
+	/**
+	* \brief Number of elements from element n to the end of its block or to uLast, whichever comes first.
+	* The end of the last block is the end of the ring, so a run never wraps.
+	*/
+	size_type run_length(size_type n, size_type uLast) const noexcept
+	{
+		size_type p = physical(n);
+		return std::min(static_cast<size_type>(layout::block_start(layout::block_of(p) + 1)) - p, uLast - n);
+	}
+
+	/**
+	* \brief std::move of elements [uFirst, uLast) to out, one run of plain pointers per block
+	*/
+	template<typename OutputIterator>
+	OutputIterator move_range(size_type uFirst, size_type uLast, OutputIterator out)
+	{
+		while (uFirst < uLast)
+		{
+			size_type uRun = run_length(uFirst, uLast);
+			value_type* pFirst = slot(physical(uFirst));
+			out = std::move(pFirst, pFirst + uRun, out);
+			uFirst += uRun;
+		}
+		return out;
+	}
+
+	/**
+	* \brief Destroys elements [uFirst, uLast), one run of plain pointers per block
+	*/
+	void destroy_range(size_type uFirst, size_type uLast) noexcept
+	{
+		while (uFirst < uLast)
+		{
+			size_type uRun = run_length(uFirst, uLast);
+			value_type* pFirst = slot(physical(uFirst));
+			for (size_type i = 0; i < uRun; ++i)
+			{
+				std::allocator_traits<allocator_type>::destroy(m_alloc, pFirst + i);
+			}
+			uFirst += uRun;
+		}
+	}
+
+	/**
+	* \brief Allocates the next block. If the elements wrap around, the ones in [0, m_uHead) move to the start of the new block,
+	* so that the ring continues in order into it. If a move throws, the list is unchanged.
+	*/
+	void add_block()
+	{
+		if (m_uBlocks == layout::max_blocks)
+		{
+			throw std::length_error("RingBinaryVectorList::add_block");
+		}
+		pointer pBlock = std::allocator_traits<allocator_type>::allocate(m_alloc, static_cast<size_type>(layout::block_size(m_uBlocks)));
+		size_type uWrapped = m_uHead + m_uSize > m_uCapacity ? m_uHead + m_uSize - m_uCapacity : 0;
+		size_type uMoved = 0;
+		try
+		{
+			for (; uMoved < uWrapped; ++uMoved)
+			{
+				std::allocator_traits<allocator_type>::construct(m_alloc, std::addressof(pBlock[uMoved]), std::move_if_noexcept(*slot(uMoved)));
+			}
+		}
+		catch (...)
+		{
+			while (uMoved)
+			{
+				--uMoved;
+				std::allocator_traits<allocator_type>::destroy(m_alloc, std::addressof(pBlock[uMoved]));
+			}
+			std::allocator_traits<allocator_type>::deallocate(m_alloc, pBlock, static_cast<size_type>(layout::block_size(m_uBlocks)));
+			throw;
+		}
+		for (size_type p = 0; p < uWrapped; ++p)
+		{
+			std::allocator_traits<allocator_type>::destroy(m_alloc, slot(p));
+		}
+		m_apBlocks[m_uBlocks] = pBlock;
+		++m_uBlocks;
+		m_uCapacity = static_cast<size_type>(layout::block_start(m_uBlocks));
+	}
+
+	pointer m_apBlocks[layout::max_blocks];
+	unsigned m_uBlocks;
+	size_type m_uCapacity;
+	/**
+	* Physical position of the front element
+	*/
+	size_type m_uHead;
+	size_type m_uSize;
+	size_type m_uWindow;
+	allocator_type m_alloc;
+};
+
+template<typename element_type, typename allocator_type>
+void swap(RingBinaryVectorList<element_type, allocator_type>& lhs, RingBinaryVectorList<element_type, allocator_type>& rhs) noexcept
+{
+	lhs.swap(rhs);
+}
@@ -0,0 +1,229 @@
+/** \file RingBinaryVectorListTest.cpp
+* \brief Tests of RingBinaryVectorList against a std::deque: growth while wrapped, eviction and window changes
+* \author Taylor Dowlen
+* \copyright GNU General Public License v3.0
+* \warning THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "RingBinaryVectorList.h"
+#include "TestCheck.h"
+
+#include <deque>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	/**
+	* \brief An element that owns heap memory and counts the live instances, so a leaked or twice destroyed slot shows up
+	*/
+	class Tracked
+	{
+	public:
+		explicit Tracked(int iValue) : m_sValue(std::to_string(iValue) + " outside the small string buffer") { ++live(); }
+		Tracked(const Tracked& rhs) : m_sValue(rhs.m_sValue) { ++live(); }
+		Tracked(Tracked&& rhs) noexcept : m_sValue(std::move(rhs.m_sValue)) { ++live(); }
+		Tracked& operator=(const Tracked&) = default;
+		Tracked& operator=(Tracked&&) = default;
+		~Tracked() { --live(); }
+
+		bool operator==(const Tracked& rhs) const { return m_sValue == rhs.m_sValue; }
+
+		static long& live()
+		{
+			static long lLive = 0;
+			return lLive;
+		}
+
+	private:
+		std::string m_sValue;
+	};
+
+	typedef RingBinaryVectorList<Tracked> ring_type;
+
+	bool same_elements(const ring_type& ring, const std::deque<Tracked>& model)
+	{
+		return ring.size() == model.size() && std::equal(model.begin(), model.end(), ring.begin())
+			&& std::equal(model.rbegin(), model.rend(), ring.rbegin());
+	}
+
+	/**
+	* \brief Pushes to both, and evicts from the model what the ring's window evicts
+	*/
+	void push_both(ring_type& ring, std::deque<Tracked>& model, int iValue)
+	{
+		ring.push_back(Tracked(iValue));
+		model.push_back(Tracked(iValue));
+		if (ring.window() && model.size() > ring.window())
+		{
+			model.pop_front();
+		}
+	}
+
+	void test_growth_while_wrapped()
+	{
+		long lLiveBefore = Tracked::live();
+		{
+			ring_type ring;
+			std::deque<Tracked> model;
+			bool bSame = true;
+			int iNext = 0;
+			//pop from the front as fast as the back grows for a while, so the contents wrap before every new block
+			for (int iRound = 0; iRound < 12; ++iRound)
+			{
+				std::size_t uTarget = ring.capacity() + 1;
+				while (ring.size() < uTarget)
+				{
+					push_both(ring, model, iNext++);
+					if (iNext % 3 == 0)
+					{
+						ring.pop_front();
+						model.pop_front();
+					}
+				}
+				bSame = bSame && same_elements(ring, model);
+			}
+			BVL_CHECK(bSame);
+			BVL_CHECK(Tracked::live() - lLiveBefore == static_cast<long>(ring.size() + model.size()));
+
+			//an argument that is one of the wrapped elements moved by the new block
+			ring.pop_front();
+			model.pop_front();
+			while (ring.size() < ring.capacity())
+			{
+				push_both(ring, model, iNext++);
+			}
+			ring.push_back(ring[ring.size() - 1]);
+			model.push_back(model.back());
+			BVL_CHECK(same_elements(ring, model));
+
+			ring_type copy(ring);
+			BVL_CHECK(same_elements(copy, model));
+			ring_type moved(std::move(copy));
+			BVL_CHECK(same_elements(moved, model) && copy.empty());
+		}
+		BVL_CHECK(Tracked::live() == lLiveBefore);
+	}
+
+	void test_eviction()
+	{
+		long lLiveBefore = Tracked::live();
+		{
+			std::mt19937_64 rng(23);
+			const std::size_t uWindow = 100;
+			ring_type ring(uWindow);
+			std::deque<Tracked> model;
+			bool bSame = true;
+			for (int i = 0; i < 5000; ++i)
+			{
+				switch (rng() % 10)
+				{
+				case 0:
+					if (!model.empty())
+					{
+						ring.pop_back();
+						model.pop_back();
+					}
+					break;
+				case 1:
+					if (!model.empty())
+					{
+						ring.pop_front();
+						model.pop_front();
+					}
+					break;
+				default:
+					push_both(ring, model, i);
+					break;
+				}
+				bSame = bSame && same_elements(ring, model) && ring.full() == (model.size() == uWindow);
+			}
+			BVL_CHECK(bSame);
+			//the window is reached once and no blocks are added after
+			BVL_CHECK(ring.capacity() >= uWindow && ring.capacity() < 2 * uWindow + 16);
+
+			//an argument that is the element the push evicts
+			while (!ring.full())
+			{
+				push_both(ring, model, -1);
+			}
+			ring.push_back(ring.front());
+			model.push_back(model.front());
+			model.pop_front();
+			BVL_CHECK(same_elements(ring, model));
+
+			std::vector<Tracked> vFront;
+			std::vector<Tracked> vBack;
+			ring.pop_front_n(30, std::back_inserter(vFront));
+			ring.pop_back_n(20, std::back_inserter(vBack));
+			BVL_CHECK(std::equal(vFront.begin(), vFront.end(), model.begin()));
+			BVL_CHECK(std::equal(vBack.begin(), vBack.end(), model.end() - 20));
+			model.erase(model.begin(), model.begin() + 30);
+			model.erase(model.end() - 20, model.end());
+			BVL_CHECK(same_elements(ring, model));
+		}
+		BVL_CHECK(Tracked::live() == lLiveBefore);
+	}
+
+	void test_set_window()
+	{
+		long lLiveBefore = Tracked::live();
+		{
+			ring_type ring(64);
+			std::deque<Tracked> model;
+			for (int i = 0; i < 1000; ++i)
+			{
+				push_both(ring, model, i);
+			}
+			BVL_CHECK(same_elements(ring, model));
+			std::size_t uCapacity = ring.capacity();
+
+			//shrinking evicts the oldest elements and keeps the blocks
+			ring.set_window(10);
+			model.erase(model.begin(), model.end() - 10);
+			BVL_CHECK(same_elements(ring, model) && ring.full());
+			BVL_CHECK(ring.capacity() == uCapacity);
+			for (int i = 0; i < 100; ++i)
+			{
+				push_both(ring, model, 1000 + i);
+			}
+			BVL_CHECK(same_elements(ring, model));
+
+			//growing the window again, then removing it
+			ring.set_window(200);
+			for (int i = 0; i < 500; ++i)
+			{
+				push_both(ring, model, 2000 + i);
+			}
+			BVL_CHECK(same_elements(ring, model) && ring.size() == 200);
+			ring.set_window(0);
+			for (int i = 0; i < 300; ++i)
+			{
+				push_both(ring, model, 3000 + i);
+			}
+			BVL_CHECK(same_elements(ring, model) && ring.size() == 500);
+
+			ring.clear();
+			model.clear();
+			BVL_CHECK(ring.empty() && Tracked::live() == lLiveBefore);
+			push_both(ring, model, 7);
+			BVL_CHECK(same_elements(ring, model));
+		}
+		BVL_CHECK(Tracked::live() == lLiveBefore);
+	}
+}
+
+void bvl::test::run_ring_tests()
+{
+	test_growth_while_wrapped();
+	test_eviction();
+	test_set_window();
+}
@@ -0,0 +1,437 @@
+/** \file StaticBinaryVectorList.h
+* \brief StaticBinaryVectorList Header File
+* \author Taylor Dowlen
+* \copyright GNU General Public License v3.0
+* \warning THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "BinaryVectorList.h"
+
+namespace bvl
+{
+	namespace detail
+	{
+		/**
+		* \brief Tells the optimizer that b is true. If it is not, the behaviour is undefined.
+		*/
+		inline void assume(bool b) noexcept
+		{
+#if defined(_MSC_VER)
+			__assume(b);
+#elif defined(__GNUC__) || defined(__clang__)
+			if (!b)
+			{
+				__builtin_unreachable();
+			}
+#else
+			(void)b;
+#endif
+		}
+	}
+}
+
+/**
+* \brief A BinaryVectorList with a capacity fixed at compile time.
+* It holds at most static_capacity = (1 << MaxLog2) - 16 elements in the same doubling blocks as BinaryVectorList,
+* so block_count is known at compile time and the block table is an array of exactly that many pointers inside the object.
+* operator[] tells the optimizer that the position is below static_capacity, so the block number is known to index the table,
+* and it compiles to the block math, one load from the table and one load of the element.
+* Blocks are still allocated as the list grows, and never move, so references stay valid.
+* Growing past static_capacity throws std::length_error.
+* \tparam value_type		The type of elements in the list.
+* \tparam MaxLog2		log2 of the capacity, rounded up. Between 5 and 63.
+* \tparam allocator_type	The type of allocator used for the blocks.
+*/
+template<typename value_type, unsigned MaxLog2, typename allocator_type = std::allocator<value_type> >
+class StaticBinaryVectorList
+{
+	static_assert(MaxLog2 > 4 && MaxLog2 < 64, "StaticBinaryVectorList: MaxLog2 must be between 5 and 63");
+
+public:
+	//Typedefs
+
+	typedef value_type& reference;
+	typedef const value_type& const_reference;
+	typedef typename std::allocator_traits<allocator_type>::pointer pointer;
+	typedef typename std::allocator_traits<allocator_type>::const_pointer const_pointer;
+	typedef bvl::BinaryVectorListIterator<StaticBinaryVectorList, value_type> iterator;
+	typedef bvl::BinaryVectorListIterator<const StaticBinaryVectorList, const value_type> const_iterator;
+	typedef std::reverse_iterator<iterator> reverse_iterator;
+	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+	typedef typename std::allocator_traits<allocator_type>::difference_type difference_type;
+	typedef typename std::allocator_traits<allocator_type>::size_type size_type;
+
+	/**
+	* The block size progression, the same as BinaryVectorList's. Block 0 holds 16 elements.
+	*/
+	typedef bvl::detail::BlockLayout<4> layout;
+
+	/**
+	* The number of blocks, and the length of the block table
+	*/
+	static const unsigned block_count = MaxLog2 - layout::first_block_log2;
+
+	/**
+	* The most elements the list can hold
+	*/
+	static const size_type static_capacity = static_cast<size_type>((std::uint64_t(1) << MaxLog2) - layout::first_block_size);
+
+	//Constructors
+
+	/**
+	* \brief Empty Container Constructor
+	* \param[in] alloc Allocator to use for the blocks.
+	*/
+	StaticBinaryVectorList(const allocator_type& alloc = allocator_type())
+		: m_apBlocks(), m_uBlocks(0), m_uSize(0), m_alloc(alloc)
+	{
+	}
+
+	/**
+	* \brief Fill Constructor
+	* \param[in] n		Number of elements.
+	* \param[in] val	The value to copy for the elements.
+	* \param[in] alloc	Allocator to use for the blocks.
+	* \throw std::length_error if n is more than static_capacity
+	*/
+	StaticBinaryVectorList(size_type n, const value_type& val = value_type(), const allocator_type& alloc = allocator_type())
+		: m_apBlocks(), m_uBlocks(0), m_uSize(0), m_alloc(alloc)
+	{
+		reserve(n);
+		for (size_type i = 0; i < n; ++i)
+		{
+			push_back(val);
+		}
+	}
+
+	/**
+	* \brief Copy Constructor
+	*/
+	StaticBinaryVectorList(const StaticBinaryVectorList& sbvl)
+		: m_apBlocks(), m_uBlocks(0), m_uSize(0), m_alloc(std::allocator_traits<allocator_type>::select_on_container_copy_construction(sbvl.m_alloc))
+	{
+		reserve(sbvl.size());
+		for (const value_type& val : sbvl)
+		{
+			push_back(val);
+		}
+	}
+
+	/**
+	* \brief Move Constructor
+	* Takes the blocks of sbvl, sbvl is left empty.
+	*/
+	StaticBinaryVectorList(StaticBinaryVectorList&& sbvl) noexcept
+		: m_apBlocks(), m_uBlocks(0), m_uSize(0), m_alloc(sbvl.m_alloc)
+	{
+		swap(sbvl);
+	}
+
+	//Destructor
+
+	~StaticBinaryVectorList()
+	{
+		clear();
+		for (unsigned k = 0; k < m_uBlocks; ++k)
+		{
+			std::allocator_traits<allocator_type>::deallocate(m_alloc, m_apBlocks[k], static_cast<size_type>(layout::block_size(k)));
+		}
+	}
+
+	//Assignment Operators
+
+	StaticBinaryVectorList& operator= (const StaticBinaryVectorList& sbvl)
+	{
+		if (this != &sbvl)
+		{
+			clear();
+			reserve(sbvl.size());
+			for (const value_type& val : sbvl)
+			{
+				push_back(val);
+			}
+		}
+		return *this;
+	}
+
+	StaticBinaryVectorList& operator= (StaticBinaryVectorList&& sbvl) noexcept
+	{
+		if (this != &sbvl)
+		{
+			clear();
+			swap(sbvl);
+		}
+		return *this;
+	}
+
+	//Iterators
+
+	iterator begin() noexcept { return iterator(this, 0); }
+	const_iterator begin() const noexcept { return const_iterator(this, 0); }
+	iterator end() noexcept { return iterator(this, m_uSize); }
+	const_iterator end() const noexcept { return const_iterator(this, m_uSize); }
+	reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+	const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+	reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+	const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+	const_iterator cbegin() const noexcept { return begin(); }
+	const_iterator cend() const noexcept { return end(); }
+
+	//Capacity
+
+	size_type size() const noexcept
+	{
+		return m_uSize;
+	}
+
+	bool empty() const noexcept
+	{
+		return m_uSize == 0;
+	}
+
+	/**
+	* \brief Whether the list holds static_capacity elements
+	*/
+	bool full() const noexcept
+	{
+		return m_uSize == static_capacity;
+	}
+
+	static size_type max_size() noexcept
+	{
+		return static_capacity;
+	}
+
+	/**
+	* \brief Elements that fit in the blocks allocated so far
+	*/
+	size_type capacity() const noexcept
+	{
+		return static_cast<size_type>(layout::block_start(m_uBlocks));
+	}
+
+	/**
+	* \brief Allocates the blocks needed to hold n elements
+	* \throw std::length_error if n is more than static_capacity
+	*/
+	void reserve(size_type n)
+	{
+		if (n > static_capacity)
+		{
+			throw std::length_error("StaticBinaryVectorList::reserve");
+		}
+		while (capacity() < n)
+		{
+			add_block();
+		}
+	}
+
+	//Element Access
+
+	/**
+	* \brief Access element. n must be less than size().
+	*/
+	reference operator[] (size_type n)
+	{
+		BVL_HARDENED_CHECK(n < m_uSize, "operator[] past the end");
+		bvl::detail::assume(n < static_capacity);
+		unsigned k = layout::block_of(n);
+		return m_apBlocks[k][static_cast<size_type>(layout::offset_of(n, k))];
+	}
+
+	/**
+	* \brief Access element. n must be less than size().
+	*/
+	const_reference operator[] (size_type n) const
+	{
+		BVL_HARDENED_CHECK(n < m_uSize, "operator[] past the end");
+		bvl::detail::assume(n < static_capacity);
+		unsigned k = layout::block_of(n);
+		return m_apBlocks[k][static_cast<size_type>(layout::offset_of(n, k))];
+	}
+
+	/**
+	* \brief Access element
+	* \throw std::out_of_range if n is not less than size()
+	*/
+	reference at(size_type n)
+	{
+		if (n >= m_uSize)
+		{
+			throw std::out_of_range("StaticBinaryVectorList::at");
+		}
+		return (*this)[n];
+	}
+
+	/**
+	* \brief Access element
+	* \throw std::out_of_range if n is not less than size()
+	*/
+	const_reference at(size_type n) const
+	{
+		if (n >= m_uSize)
+		{
+			throw std::out_of_range("StaticBinaryVectorList::at");
+		}
+		return (*this)[n];
+	}
+
+	reference front() { return (*this)[0]; }
+	const_reference front() const { return (*this)[0]; }
+	reference back() { return (*this)[m_uSize - 1]; }
+	const_reference back() const { return (*this)[m_uSize - 1]; }
+
+	//Modifiers
+
+	void push_back(const value_type& val)
+	{
+		emplace_back(val);
+	}
+
+	void push_back(value_type&& val)
+	{
+		emplace_back(std::move(val));
+	}
+
+	/**
+	* \brief Construct an element at the end
+	* \throw std::length_error if the list is full
+	*/
+	template<typename... Args>
+	void emplace_back(Args&&... args)
+	{
+		if (m_uSize == static_capacity)
+		{
+			throw std::length_error("StaticBinaryVectorList::emplace_back");
+		}
+		unsigned k = layout::block_of(m_uSize);
+		if (k == m_uBlocks)
+		{
+			add_block();
+		}
+		std::allocator_traits<allocator_type>::construct(m_alloc, std::addressof(m_apBlocks[k][static_cast<size_type>(layout::offset_of(m_uSize, k))]), std::forward<Args>(args)...);
+		++m_uSize;
+	}
+
+	void pop_back()
+	{
+		BVL_HARDENED_CHECK(m_uSize != 0, "pop_back() of an empty list");
+		--m_uSize;
+		std::allocator_traits<allocator_type>::destroy(m_alloc, locate(m_uSize));
+		invalidate();
+	}
+
+	/**
+	* \brief Destroys every element. The blocks stay allocated.
+	*/
+	void clear() noexcept
+	{
+		while (m_uSize)
+		{
+			pop_back();
+		}
+	}
+
+	void swap(StaticBinaryVectorList& sbvl) noexcept
+	{
+		std::swap(m_apBlocks, sbvl.m_apBlocks);
+		std::swap(m_uBlocks, sbvl.m_uBlocks);
+		std::swap(m_uSize, sbvl.m_uSize);
+		std::swap(m_alloc, sbvl.m_alloc);
+		invalidate();
+		sbvl.invalidate();
+	}
+
+	allocator_type get_allocator() const noexcept
+	{
+		return m_alloc;
+	}
+
+	/**
+	* \brief Whether position n is the first element of a block. Used by the iterators to detect block crossings.
+	*/
+	static bool is_block_start(size_type n) noexcept
+	{
+		return layout::is_block_start(n);
+	}
+
+	/**
+	* \brief Hints the element at position n into the cache. Does nothing if n is past the capacity.
+	*/
+	void prefetch(size_type n) const noexcept
+	{
+		const value_type* p = locate(n);
+		if (p)
+		{
+			bvl::detail::prefetch(p);
+		}
+	}
+
+protected:
+	template<typename, typename> friend class bvl::BinaryVectorListIterator;
+
+	/**
+	* \brief Address of position n, or nullptr if n lies in a block that is not allocated
+	*/
+	value_type* locate(size_type n) noexcept
+	{
+		unsigned k = layout::block_of(n);
+		return k < m_uBlocks ? std::addressof(m_apBlocks[k][static_cast<size_type>(layout::offset_of(n, k))]) : nullptr;
+	}
+
+	/**
+	* \brief Address of position n, or nullptr if n lies in a block that is not allocated
+	*/
+	const value_type* locate(size_type n) const noexcept
+	{
+		unsigned k = layout::block_of(n);
+		return k < m_uBlocks ? std::addressof(m_apBlocks[k][static_cast<size_type>(layout::offset_of(n, k))]) : nullptr;
+	}
+
+	/**
+	* \brief Advances the generation, in hardened mode, so that existing iterators are reported if they are used again
+	*/
+	void invalidate() noexcept
+	{
+#if BVL_HARDENED
+		++m_uGeneration;
+#endif
+	}
+
+	void add_block()
+	{
+		m_apBlocks[m_uBlocks] = std::allocator_traits<allocator_type>::allocate(m_alloc, static_cast<size_type>(layout::block_size(m_uBlocks)));
+		++m_uBlocks;
+	}
+
+	pointer m_apBlocks[block_count];
+	unsigned m_uBlocks;
+	size_type m_uSize;
+	allocator_type m_alloc;
+#if BVL_HARDENED
+	std::size_t m_uGeneration = 0;
+#endif
+};
+
+template<typename value_type, unsigned MaxLog2, typename allocator_type>
+const unsigned StaticBinaryVectorList<value_type, MaxLog2, allocator_type>::block_count;
+
+template<typename value_type, unsigned MaxLog2, typename allocator_type>
+const typename StaticBinaryVectorList<value_type, MaxLog2, allocator_type>::size_type StaticBinaryVectorList<value_type, MaxLog2, allocator_type>::static_capacity;
+
+/**
+* \brief Swap two StaticBinaryVectorLists
+*/
+template<typename value_type, unsigned MaxLog2, typename allocator_type>
+void swap(StaticBinaryVectorList<value_type, MaxLog2, allocator_type>& lhs, StaticBinaryVectorList<value_type, MaxLog2, allocator_type>& rhs) noexcept
+{
+	lhs.swap(rhs);
+}
@@ -0,0 +1,52 @@
+/** \file TestCheck.h
+* \brief The check macro shared by the test files, and the entry points TestMain.cpp runs
+* \author Taylor Dowlen
+* \copyright GNU General Public License v3.0
+* \warning THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdio>
+
+namespace bvl
+{
+	namespace test
+	{
+		/**
+		* \brief Number of failed checks so far, over every test file
+		*/
+		inline int& failures()
+		{
+			static int iFailures = 0;
+			return iFailures;
+		}
+
+		/**
+		* \brief Reports a failed check and keeps going, so one run lists every failure
+		*/
+		inline void check(bool bPassed, const char* pExpression, const char* pFile, int iLine)
+		{
+			if (!bPassed)
+			{
+				std::fprintf(stderr, "%s(%d): check failed: %s\n", pFile, iLine, pExpression);
+				++failures();
+			}
+		}
+
+		//Entry points, one per test file
+		void run_binary_vector_list_tests();
+		void run_compressed_tests();
+		void run_priority_queue_tests();
+		void run_ring_tests();
+		void run_tiered_tests();
+	}
+}
+
+#define BVL_CHECK(expression) bvl::test::check((expression) ? true : false, #expression, __FILE__, __LINE__)
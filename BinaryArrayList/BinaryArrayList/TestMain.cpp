@@ -0,0 +1,33 @@
+/** \file TestMain.cpp
+* \brief Runs the tests of every test file
+* \author Taylor Dowlen
+* \copyright GNU General Public License v3.0
+* \warning THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "TestCheck.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+int main()
+{
+	bvl::test::run_binary_vector_list_tests();
+	bvl::test::run_compressed_tests();
+	bvl::test::run_priority_queue_tests();
+	bvl::test::run_ring_tests();
+	bvl::test::run_tiered_tests();
+	if (bvl::test::failures())
+	{
+		std::fprintf(stderr, "%d checks failed\n", bvl::test::failures());
+		return EXIT_FAILURE;
+	}
+	std::printf("All checks passed\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,1053 @@
+/** \file TieredBinaryVectorList.h
+* \brief TieredBinaryVectorList Header File
+* \author Taylor Dowlen
+* \copyright GNU General Public License v3.0
+* \warning THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "BinaryVectorList.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <list>
+#include <mutex>
+#include <queue>
+#include <string>
+
+#if defined(BVL_USE_LZ4)
+#include <lz4.h>
+#endif
+#if defined(BVL_USE_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace bvl
+{
+	namespace detail
+	{
+		/**
+		* \brief floor(log2(x)) for constant expressions
+		*/
+		constexpr unsigned static_floor_log2(std::size_t x)
+		{
+			return x <= 1 ? 0 : 1 + static_floor_log2(x / 2);
+		}
+
+		/**
+		* \brief An append only scratch file, for evicted chunks and the runs of external_sort. It is deleted when closed.
+		*/
+		class SpillFile
+		{
+		public:
+			explicit SpillFile(const std::string& sPath) : m_sPath(sPath), m_pFile(std::fopen(sPath.c_str(), "w+b")), m_uEnd(0)
+			{
+				if (!m_pFile)
+				{
+					throw std::runtime_error("SpillFile: cannot open " + sPath);
+				}
+			}
+
+			SpillFile(const SpillFile&) = delete;
+			SpillFile& operator=(const SpillFile&) = delete;
+
+			~SpillFile()
+			{
+				std::fclose(m_pFile);
+				std::remove(m_sPath.c_str());
+			}
+
+			/**
+			* \brief Writes uBytes bytes at the end of the file
+			* \return The offset they were written at
+			*/
+			std::uint64_t append(const void* pData, std::size_t uBytes)
+			{
+				std::uint64_t uOffset = m_uEnd;
+				seek(uOffset);
+				if (std::fwrite(pData, 1, uBytes, m_pFile) != uBytes)
+				{
+					throw std::runtime_error("SpillFile: write failed");
+				}
+				m_uEnd += uBytes;
+				return uOffset;
+			}
+
+			void read(std::uint64_t uOffset, void* pData, std::size_t uBytes)
+			{
+				seek(uOffset);
+				if (std::fread(pData, 1, uBytes, m_pFile) != uBytes)
+				{
+					throw std::runtime_error("SpillFile: read failed");
+				}
+			}
+
+			/**
+			* \brief Lets the space be written over again, once nothing refers to it
+			*/
+			void reset() noexcept
+			{
+				m_uEnd = 0;
+			}
+
+			/**
+			* \brief Gives back the space from uOffset to the end, so the next append writes over it.
+			* The file keeps its size on disk, the space is reused rather than returned to the file system.
+			*/
+			void release_tail(std::uint64_t uOffset) noexcept
+			{
+				m_uEnd = std::min(m_uEnd, uOffset);
+			}
+
+			/**
+			* \brief Bytes in use, from the start of the file
+			*/
+			std::uint64_t size() const noexcept
+			{
+				return m_uEnd;
+			}
+
+			const std::string& path() const noexcept
+			{
+				return m_sPath;
+			}
+
+		private:
+			void seek(std::uint64_t uOffset)
+			{
+#if defined(_MSC_VER)
+				int iResult = _fseeki64(m_pFile, static_cast<__int64>(uOffset), SEEK_SET);
+#else
+				int iResult = fseeko(m_pFile, static_cast<off_t>(uOffset), SEEK_SET);
+#endif
+				if (iResult != 0)
+				{
+					throw std::runtime_error("SpillFile: seek failed");
+				}
+			}
+
+			std::string m_sPath;
+			std::FILE* m_pFile;
+			std::uint64_t m_uEnd;
+		};
+
+		/**
+		* \brief Reads one sorted run of external_sort back from the scratch file.
+		* It has two buffers: the merge takes elements from one while the next part of the run is read into the other on another thread.
+		*/
+		template<typename element_type>
+		class RunReader
+		{
+		public:
+			RunReader(SpillFile& file, std::mutex& mtxFile, std::uint64_t uOffset, std::size_t uCount, std::size_t uBuffer)
+				: m_file(file), m_mtxFile(mtxFile), m_uOffset(uOffset), m_uLeft(uCount), m_uBuffer(uBuffer), m_uPos(0)
+			{
+				prefetch();
+				next_buffer();
+			}
+
+			RunReader(const RunReader&) = delete;
+			RunReader& operator=(const RunReader&) = delete;
+
+			bool empty() const noexcept
+			{
+				return m_uPos == m_vCurrent.size();
+			}
+
+			const element_type& front() const noexcept
+			{
+				return m_vCurrent[m_uPos];
+			}
+
+			void pop()
+			{
+				if (++m_uPos == m_vCurrent.size())
+				{
+					next_buffer();
+				}
+			}
+
+		private:
+			/**
+			* \brief Waits for the read in flight, makes it the current buffer and starts reading the part after it
+			*/
+			void next_buffer()
+			{
+				m_uPos = 0;
+				if (!m_fNext.valid())
+				{
+					m_vCurrent.clear();
+					return;
+				}
+				m_fNext.get();
+				m_vCurrent.swap(m_vNext);
+				prefetch();
+			}
+
+			void prefetch()
+			{
+				if (m_uLeft == 0)
+				{
+					return;
+				}
+				std::size_t uCount = std::min(m_uLeft, m_uBuffer);
+				std::uint64_t uOffset = m_uOffset;
+				m_vNext.resize(uCount);
+				m_uOffset += uCount * sizeof(element_type);
+				m_uLeft -= uCount;
+				m_fNext = std::async(std::launch::async, [this, uOffset, uCount]()
+				{
+					std::lock_guard<std::mutex> lock(m_mtxFile);
+					m_file.read(uOffset, m_vNext.data(), uCount * sizeof(element_type));
+				});
+			}
+
+			SpillFile& m_file;
+			std::mutex& m_mtxFile;
+			std::uint64_t m_uOffset;
+			std::size_t m_uLeft;
+			std::size_t m_uBuffer;
+			std::size_t m_uPos;
+			std::vector<element_type> m_vCurrent;
+			std::vector<element_type> m_vNext;
+			std::future<void> m_fNext;
+		};
+	}
+
+	/**
+	* \brief Cold block codec that stores the bytes as they are, for spilling to disk without compressing
+	*/
+	struct NullCodec
+	{
+		static void compress(const unsigned char* pSrc, std::size_t uBytes, std::size_t, std::vector<unsigned char>& vOut)
+		{
+			vOut.assign(pSrc, pSrc + uBytes);
+		}
+
+		static void decompress(const unsigned char* pSrc, std::size_t uSrcBytes, unsigned char* pDst, std::size_t, std::size_t)
+		{
+			std::memcpy(pDst, pSrc, uSrcBytes);
+		}
+	};
+
+	/**
+	* \brief Built in cold block codec.
+	* Transposes the bytes so that byte b of every element is stored together (the high bytes of small or
+	* slowly changing numbers are mostly equal), then run length encodes the result with PackBits.
+	* It needs no library. Define BVL_USE_LZ4 or BVL_USE_ZSTD to make one of those the default instead.
+	*/
+	struct ShuffleRleCodec
+	{
+		/**
+		* \brief Compresses uBytes bytes of elements that are uElementSize bytes each
+		*/
+		static void compress(const unsigned char* pSrc, std::size_t uBytes, std::size_t uElementSize, std::vector<unsigned char>& vOut)
+		{
+			std::size_t uCount = uBytes / uElementSize;
+			std::vector<unsigned char> vPlanes(uBytes);
+			for (std::size_t e = 0; e < uCount; ++e)
+			{
+				for (std::size_t b = 0; b < uElementSize; ++b)
+				{
+					vPlanes[b * uCount + e] = pSrc[e * uElementSize + b];
+				}
+			}
+			vOut.clear();
+			std::size_t i = 0;
+			while (i < uBytes)
+			{
+				std::size_t uRun = 1;
+				while (i + uRun < uBytes && uRun < 128 && vPlanes[i + uRun] == vPlanes[i])
+				{
+					++uRun;
+				}
+				if (uRun >= 3)
+				{
+					vOut.push_back(static_cast<unsigned char>(257 - uRun));
+					vOut.push_back(vPlanes[i]);
+					i += uRun;
+					continue;
+				}
+				//literals run until the next run of 3 equal bytes
+				std::size_t uLiteral = 0;
+				while (i + uLiteral < uBytes && uLiteral < 128 &&
+					!(i + uLiteral + 2 < uBytes && vPlanes[i + uLiteral] == vPlanes[i + uLiteral + 1] && vPlanes[i + uLiteral] == vPlanes[i + uLiteral + 2]))
+				{
+					++uLiteral;
+				}
+				vOut.push_back(static_cast<unsigned char>(uLiteral - 1));
+				vOut.insert(vOut.end(), vPlanes.begin() + i, vPlanes.begin() + i + uLiteral);
+				i += uLiteral;
+			}
+		}
+
+		/**
+		* \brief Restores uDstBytes bytes of elements that are uElementSize bytes each
+		*/
+		static void decompress(const unsigned char* pSrc, std::size_t uSrcBytes, unsigned char* pDst, std::size_t uDstBytes, std::size_t uElementSize)
+		{
+			std::vector<unsigned char> vPlanes;
+			vPlanes.reserve(uDstBytes);
+			for (std::size_t i = 0; i < uSrcBytes;)
+			{
+				unsigned uControl = pSrc[i++];
+				if (uControl < 128)
+				{
+					vPlanes.insert(vPlanes.end(), pSrc + i, pSrc + i + uControl + 1);
+					i += uControl + 1;
+				}
+				else if (uControl > 128)
+				{
+					vPlanes.insert(vPlanes.end(), 257 - uControl, pSrc[i++]);
+				}
+			}
+			std::size_t uCount = uDstBytes / uElementSize;
+			for (std::size_t e = 0; e < uCount; ++e)
+			{
+				for (std::size_t b = 0; b < uElementSize; ++b)
+				{
+					pDst[e * uElementSize + b] = vPlanes[b * uCount + e];
+				}
+			}
+		}
+	};
+
+#if defined(BVL_USE_LZ4)
+	/**
+	* \brief Cold block codec backed by LZ4 (link with liblz4)
+	*/
+	struct Lz4Codec
+	{
+		static void compress(const unsigned char* pSrc, std::size_t uBytes, std::size_t, std::vector<unsigned char>& vOut)
+		{
+			vOut.resize(static_cast<std::size_t>(LZ4_compressBound(static_cast<int>(uBytes))));
+			int iWritten = LZ4_compress_default(reinterpret_cast<const char*>(pSrc), reinterpret_cast<char*>(vOut.data()), static_cast<int>(uBytes), static_cast<int>(vOut.size()));
+			if (iWritten <= 0)
+			{
+				throw std::runtime_error("Lz4Codec::compress");
+			}
+			vOut.resize(static_cast<std::size_t>(iWritten));
+		}
+
+		static void decompress(const unsigned char* pSrc, std::size_t uSrcBytes, unsigned char* pDst, std::size_t uDstBytes, std::size_t)
+		{
+			if (LZ4_decompress_safe(reinterpret_cast<const char*>(pSrc), reinterpret_cast<char*>(pDst), static_cast<int>(uSrcBytes), static_cast<int>(uDstBytes)) != static_cast<int>(uDstBytes))
+			{
+				throw std::runtime_error("Lz4Codec::decompress");
+			}
+		}
+	};
+#endif
+
+#if defined(BVL_USE_ZSTD)
+	/**
+	* \brief Cold block codec backed by zstd (link with libzstd)
+	*/
+	struct ZstdCodec
+	{
+		static void compress(const unsigned char* pSrc, std::size_t uBytes, std::size_t, std::vector<unsigned char>& vOut)
+		{
+			vOut.resize(ZSTD_compressBound(uBytes));
+			std::size_t uWritten = ZSTD_compress(vOut.data(), vOut.size(), pSrc, uBytes, 1);
+			if (ZSTD_isError(uWritten))
+			{
+				throw std::runtime_error("ZstdCodec::compress");
+			}
+			vOut.resize(uWritten);
+		}
+
+		static void decompress(const unsigned char* pSrc, std::size_t uSrcBytes, unsigned char* pDst, std::size_t uDstBytes, std::size_t)
+		{
+			if (ZSTD_decompress(pDst, uDstBytes, pSrc, uSrcBytes) != uDstBytes)
+			{
+				throw std::runtime_error("ZstdCodec::decompress");
+			}
+		}
+	};
+#endif
+
+#if defined(BVL_USE_LZ4)
+	typedef Lz4Codec DefaultColdCodec;
+#elif defined(BVL_USE_ZSTD)
+	typedef ZstdCodec DefaultColdCodec;
+#else
+	typedef ShuffleRleCodec DefaultColdCodec;
+#endif
+}
+
+/**
+* \brief An append mostly BinaryVectorList that keeps its older elements compressed.
+* Elements are grouped in chunks of about 256KB. A chunk never changes once it is full,
+* so when a chunk is followed by more than hot_chunks full chunks it is compressed, on a background thread by default,
+* and its uncompressed copy is released the next time the list is modified.
+* Reading a compressed chunk decompresses it into a small LRU cache, so scans of old data only pay for each chunk once.
+* Chunks are used instead of the doubling blocks because the newest full block is always half of the list,
+* and it would never be cold.
+* With set_spill_file() the list also has a disk tier: when the chunks held in memory exceed the memory budget,
+* the oldest compressed chunks are written to the spill file and freed, and reading them faults them back in
+* through the same LRU cache. Lists larger than RAM then slow down instead of running out of memory.
+* The spilled chunks are always the oldest ones and are stored in order, so the chunk pop_back reads back is at the end
+* of the file and its space is reused by the next spill. The file does not shrink on disk until the list is destroyed.
+* Elements are returned by value, writes are only possible at the end of the list.
+* Reads may run concurrently with each other, but not with modifications.
+* \tparam element_type The type of elements. It must be trivially copyable, chunks are compressed as bytes.
+* \tparam codec_type The codec for cold chunks, see bvl::ShuffleRleCodec for the interface.
+* \tparam allocator_type The type of allocator to use for the uncompressed chunks.
+*/
+template<typename element_type, typename codec_type = bvl::DefaultColdCodec, typename allocator_type = std::allocator<element_type> >
+class TieredBinaryVectorList
+{
+	static_assert(std::is_trivially_copyable<element_type>::value, "TieredBinaryVectorList compresses elements as bytes, they must be trivially copyable");
+
+public:
+	//Typedefs
+
+	typedef element_type value_type;
+	typedef element_type const_reference;
+	typedef std::size_t size_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef bvl::BinaryVectorListIndexIterator<const TieredBinaryVectorList, element_type> const_iterator;
+	typedef const_iterator iterator;
+
+	/**
+	* log2 of the number of elements in a chunk, chosen so that a chunk is at most 256KB
+	*/
+	static const unsigned chunk_log2 = bvl::detail::static_floor_log2(sizeof(element_type) < 262144 ? 262144 / sizeof(element_type) : 1);
+
+	/**
+	* The number of elements in a chunk
+	*/
+	static const size_type chunk_size = size_type(1) << chunk_log2;
+
+	//Constructors
+
+	/**
+	* \brief Empty Container Constructor
+	* \param[in] uHotChunks		Number of full chunks, counting back from the end, that are kept uncompressed.
+	* \param[in] uCacheChunks	Number of decompressed chunks to keep in the LRU cache.
+	* \param[in] bBackground	Whether to compress on a background thread. Otherwise push_back compresses in place.
+	* \param[in] alloc			Allocator to use for the uncompressed chunks.
+	*/
+	explicit TieredBinaryVectorList(size_type uHotChunks = 2, size_type uCacheChunks = 8, bool bBackground = true, const allocator_type& alloc = allocator_type())
+		: m_uSize(0), m_uHotChunks(uHotChunks), m_uCacheChunks(uCacheChunks ? uCacheChunks : 1), m_bBackground(bBackground),
+		m_uResidentBytes(0), m_uMemoryBudget(0), m_uSpillCursor(0), m_pCacheMutex(new std::mutex), m_alloc(alloc)
+	{
+	}
+
+	/**
+	* \brief Move Constructor
+	* Background compressions in flight keep running, they write into chunks that change owner but not address.
+	* \param[in] bvl	TieredBinaryVectorList to acquire elements from. It is left empty, with its settings and a cache of its own.
+	*/
+	TieredBinaryVectorList(TieredBinaryVectorList&& bvl)
+		: TieredBinaryVectorList(bvl.m_uHotChunks, bvl.m_uCacheChunks, bvl.m_bBackground, bvl.m_alloc)
+	{
+		swap(bvl);
+	}
+
+	/**
+	* \brief Move Assignment
+	* The elements held before are released as if the list was destroyed.
+	*/
+	TieredBinaryVectorList& operator= (TieredBinaryVectorList&& bvl)
+	{
+		if (this != &bvl)
+		{
+			TieredBinaryVectorList tmp(std::move(bvl));
+			swap(tmp);
+		}
+		return *this;
+	}
+
+	/**
+	* \brief Destructor
+	* Waits for background compression to finish, the tasks read from the chunks being destroyed.
+	*/
+	~TieredBinaryVectorList()
+	{
+		flush();
+	}
+
+	//Iterators
+
+	const_iterator begin() const noexcept { return const_iterator(this, 0); }
+	const_iterator end() const noexcept { return const_iterator(this, m_uSize); }
+	const_iterator cbegin() const noexcept { return begin(); }
+	const_iterator cend() const noexcept { return end(); }
+
+	//Capacity
+
+	size_type size() const noexcept
+	{
+		return m_uSize;
+	}
+
+	bool empty() const noexcept
+	{
+		return m_uSize == 0;
+	}
+
+	/**
+	* \brief Bytes held in memory by uncompressed chunks, compressed chunks, the decompression cache and the spill read buffer
+	*/
+	size_type memory_usage() const
+	{
+		std::lock_guard<std::mutex> lock(*m_pCacheMutex);
+		return m_uResidentBytes + m_lCache.size() * chunk_size * sizeof(element_type) + m_vSpillBytes.capacity();
+	}
+
+	/**
+	* \brief Evict cold chunks to a spill file whenever the chunks held in memory exceed a budget
+	* The file is created (or truncated) now and deleted when the list is destroyed.
+	* If the list already spills to another file, the spilled chunks are copied to the new one a chunk at a time,
+	* so at most one compressed chunk is in memory at once. Passing the current path only changes the budget.
+	* The decompression cache is not part of the budget, it is bounded by its chunk count.
+	* \param[in] sPath			Path of the spill file.
+	* \param[in] uMemoryBudget	Bytes of uncompressed and compressed chunks to keep in memory.
+	*/
+	void set_spill_file(const std::string& sPath, size_type uMemoryBudget)
+	{
+		flush();
+		if (!m_pSpill || m_pSpill->path() != sPath)
+		{
+			std::unique_ptr<bvl::detail::SpillFile> pSpill(new bvl::detail::SpillFile(sPath));
+			if (m_pSpill)
+			{
+				//the chunks only get their new offsets once all of them are copied, so a failed copy leaves the old file in use
+				std::vector<std::uint64_t> vOffsets;
+				for (const Chunk& chunk : m_chunks)
+				{
+					if (chunk.bSpilled)
+					{
+						m_vSpillBytes.resize(chunk.uSpillBytes);
+						m_pSpill->read(chunk.uSpillOffset, m_vSpillBytes.data(), chunk.uSpillBytes);
+						vOffsets.push_back(pSpill->append(m_vSpillBytes.data(), chunk.uSpillBytes));
+					}
+				}
+				std::vector<std::uint64_t>::const_iterator itOffset = vOffsets.begin();
+				for (Chunk& chunk : m_chunks)
+				{
+					if (chunk.bSpilled)
+					{
+						chunk.uSpillOffset = *itOffset++;
+					}
+				}
+			}
+			m_pSpill.swap(pSpill);
+		}
+		m_uMemoryBudget = uMemoryBudget;
+		m_uSpillCursor = 0;
+		spill();
+	}
+
+	//Element Access
+
+	/**
+	* \brief Read an element
+	* Hot chunks are read in place. Cold chunks are read through the decompression cache.
+	* \param[in] n Position of the desired element.
+	* \return A copy of the element at position n
+	*/
+	element_type operator[] (size_type n) const
+	{
+		const Chunk& chunk = m_chunks[n >> chunk_log2];
+		size_type uOffset = n & (chunk_size - 1);
+		if (!chunk.vRaw.empty())
+		{
+			return chunk.vRaw[uOffset];
+		}
+		std::lock_guard<std::mutex> lock(*m_pCacheMutex);
+		return cached_chunk(n >> chunk_log2)[uOffset];
+	}
+
+	element_type at(size_type n) const
+	{
+		if (n >= m_uSize)
+		{
+			throw std::out_of_range("TieredBinaryVectorList::at");
+		}
+		return (*this)[n];
+	}
+
+	element_type front() const { return (*this)[0]; }
+	element_type back() const { return (*this)[m_uSize - 1]; }
+
+	/**
+	* \brief Copy a range of elements out, a chunk at a time
+	* \param[in] first	Position of the first element to read.
+	* \param[in] count	Number of elements to read.
+	* \param[out] pOut	Where to write the elements. Must have room for count elements.
+	*/
+	void read(size_type first, size_type count, element_type* pOut) const
+	{
+		while (count)
+		{
+			size_type uChunk = first >> chunk_log2;
+			size_type uOffset = first & (chunk_size - 1);
+			size_type uTaken = std::min(count, chunk_size - uOffset);
+			const Chunk& chunk = m_chunks[uChunk];
+			if (!chunk.vRaw.empty())
+			{
+				std::copy(chunk.vRaw.begin() + uOffset, chunk.vRaw.begin() + uOffset + uTaken, pOut);
+			}
+			else
+			{
+				std::lock_guard<std::mutex> lock(*m_pCacheMutex);
+				const chunk_vector_type& vChunk = cached_chunk(uChunk);
+				std::copy(vChunk.begin() + uOffset, vChunk.begin() + uOffset + uTaken, pOut);
+			}
+			first += uTaken;
+			pOut += uTaken;
+			count -= uTaken;
+		}
+	}
+
+	//Modifiers
+
+	/**
+	* \brief Add an element at the end
+	* Finished background compressions are committed first, releasing their uncompressed chunks.
+	* \param[in] val Value to append
+	*/
+	void push_back(const element_type& val)
+	{
+		collect(false);
+		size_type uChunk = m_uSize >> chunk_log2;
+		if (uChunk == m_chunks.size())
+		{
+			m_chunks.emplace_back();
+			m_chunks.back().vRaw = chunk_vector_type(m_alloc);
+			m_chunks.back().vRaw.reserve(chunk_size);
+			m_uResidentBytes += chunk_bytes(m_chunks.back());
+		}
+		Chunk& chunk = m_chunks[uChunk];
+		chunk.vRaw.push_back(val);
+		++m_uSize;
+		if (chunk.vRaw.size() == chunk_size && uChunk >= m_uHotChunks)
+		{
+			cool(uChunk - m_uHotChunks);
+		}
+	}
+
+	/**
+	* \brief Remove the last element
+	* If the last chunk is compressed it is decompressed back into a hot chunk first.
+	*/
+	void pop_back()
+	{
+		size_type uChunk = (m_uSize - 1) >> chunk_log2;
+		warm(uChunk);
+		Chunk& chunk = m_chunks[uChunk];
+		chunk.vRaw.pop_back();
+		--m_uSize;
+		if (chunk.vRaw.empty())
+		{
+			m_uResidentBytes -= chunk_bytes(chunk);
+			m_chunks.pop_back();
+			m_uSpillCursor = std::min(m_uSpillCursor, m_chunks.size());
+		}
+	}
+
+	void clear()
+	{
+		flush();
+		m_chunks.clear();
+		std::lock_guard<std::mutex> lock(*m_pCacheMutex);
+		m_lCache.clear();
+		m_uSize = 0;
+		m_uResidentBytes = 0;
+		m_uSpillCursor = 0;
+		if (m_pSpill)
+		{
+			m_pSpill->reset();
+		}
+	}
+
+	void swap(TieredBinaryVectorList& bvl) noexcept
+	{
+		m_chunks.swap(bvl.m_chunks);
+		m_dPending.swap(bvl.m_dPending);
+		m_lCache.swap(bvl.m_lCache);
+		m_vSpillBytes.swap(bvl.m_vSpillBytes);
+		std::swap(m_uSize, bvl.m_uSize);
+		std::swap(m_uHotChunks, bvl.m_uHotChunks);
+		std::swap(m_uCacheChunks, bvl.m_uCacheChunks);
+		std::swap(m_bBackground, bvl.m_bBackground);
+		std::swap(m_uResidentBytes, bvl.m_uResidentBytes);
+		std::swap(m_uMemoryBudget, bvl.m_uMemoryBudget);
+		std::swap(m_uSpillCursor, bvl.m_uSpillCursor);
+		m_pSpill.swap(bvl.m_pSpill);
+		m_pCacheMutex.swap(bvl.m_pCacheMutex);
+		std::swap(m_alloc, bvl.m_alloc);
+	}
+
+	/**
+	* \brief Wait for every background compression and release the uncompressed chunks
+	*/
+	void flush()
+	{
+		collect(true);
+	}
+
+	/**
+	* \brief Sort the elements by comp without holding the list, or a second copy of it, in memory
+	* The list is read in runs of uMemoryBudget bytes (whole chunks, at least one). Each run is sorted and appended to a scratch file in sTempDir,
+	* then a k-way merge of the runs fills a new list with the same settings, which compresses and spills like this one as it grows,
+	* to a second file in sTempDir. Each run is read back through two buffers, one being merged while the next part of the run is read into the other,
+	* and all of them together take uMemoryBudget bytes.
+	* The new list replaces this one only once the merge is complete, so if anything throws before that the list is unchanged.
+	* A spilling list then moves its spilled chunks back to its own spill file. If that copy fails, the list is sorted but keeps spilling to the file in sTempDir.
+	* The sort is not stable.
+	* \param[in] sTempDir		Directory for the scratch files, the current directory if empty
+	* \param[in] uMemoryBudget	Bytes to sort at a time, and to buffer the merge with
+	* \param[in] comp			Strict weak ordering of the elements
+	* \throw std::runtime_error if a scratch file can not be created, written or read
+	*/
+	template<typename Compare>
+	void external_sort(const std::string& sTempDir, size_type uMemoryBudget, Compare comp)
+	{
+		if (m_uSize < 2)
+		{
+			return;
+		}
+		flush();
+		const std::string sScratch = (sTempDir.empty() ? std::string() : sTempDir + "/") + "bvl_external_sort_"
+			+ std::to_string(reinterpret_cast<std::uintptr_t>(this)) + "_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+		const std::string sSpillPath = m_pSpill ? m_pSpill->path() : std::string();
+		TieredBinaryVectorList sorted(m_uHotChunks, m_uCacheChunks, m_bBackground, m_alloc);
+		if (m_pSpill)
+		{
+			sorted.set_spill_file(sScratch + ".spill", m_uMemoryBudget);
+		}
+		size_type uRun = std::max<size_type>(uMemoryBudget / sizeof(element_type) >> chunk_log2, 1) << chunk_log2;
+		std::vector<element_type> vRun(std::min(uRun, m_uSize));
+		if (m_uSize <= uRun)
+		{
+			read(0, m_uSize, vRun.data());
+			std::sort(vRun.begin(), vRun.end(), comp);
+			for (const element_type& val : vRun)
+			{
+				sorted.push_back(val);
+			}
+		}
+		else
+		{
+			bvl::detail::SpillFile file(sScratch + ".runs");
+			std::vector<std::uint64_t> vOffsets;
+			std::vector<size_type> vCounts;
+			for (size_type uFirst = 0; uFirst < m_uSize; uFirst += uRun)
+			{
+				size_type uCount = std::min(uRun, m_uSize - uFirst);
+				read(uFirst, uCount, vRun.data());
+				std::sort(vRun.begin(), vRun.begin() + static_cast<difference_type>(uCount), comp);
+				vOffsets.push_back(file.append(vRun.data(), uCount * sizeof(element_type)));
+				vCounts.push_back(uCount);
+			}
+			//the merge buffers take the budget from here
+			std::vector<element_type>().swap(vRun);
+			//Two buffers per run share the budget, but every read is at least a page
+			size_type uBuffer = std::max<size_type>(uMemoryBudget / sizeof(element_type) / (2 * vOffsets.size()), 4096 / sizeof(element_type) + 1);
+			std::mutex mtxFile;
+			std::vector<std::unique_ptr<bvl::detail::RunReader<element_type> > > vpReaders;
+			for (std::size_t r = 0; r < vOffsets.size(); ++r)
+			{
+				vpReaders.push_back(std::unique_ptr<bvl::detail::RunReader<element_type> >(new bvl::detail::RunReader<element_type>(file, mtxFile, vOffsets[r], vCounts[r], uBuffer)));
+			}
+			//The run with the smallest next element is on top
+			auto later = [&vpReaders, &comp](std::size_t a, std::size_t b) { return comp(vpReaders[b]->front(), vpReaders[a]->front()); };
+			std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(later)> heap(later);
+			for (std::size_t r = 0; r < vpReaders.size(); ++r)
+			{
+				heap.push(r);
+			}
+			while (!heap.empty())
+			{
+				std::size_t r = heap.top();
+				heap.pop();
+				sorted.push_back(vpReaders[r]->front());
+				vpReaders[r]->pop();
+				if (!vpReaders[r]->empty())
+				{
+					heap.push(r);
+				}
+			}
+		}
+		sorted.flush();
+		swap(sorted);
+		//the unsorted elements and their spill file go before the sorted list takes over the file's path
+		{
+			TieredBinaryVectorList unsorted(std::move(sorted));
+		}
+		if (!sSpillPath.empty())
+		{
+			set_spill_file(sSpillPath, m_uMemoryBudget);
+		}
+	}
+
+	/**
+	* \brief Sort the elements with operator< (see external_sort(sTempDir, uMemoryBudget, comp))
+	*/
+	void external_sort(const std::string& sTempDir, size_type uMemoryBudget)
+	{
+		external_sort(sTempDir, uMemoryBudget, std::less<element_type>());
+	}
+
+	allocator_type get_allocator() const noexcept
+	{
+		return m_alloc;
+	}
+
+protected:
+	typedef std::vector<element_type, allocator_type> chunk_vector_type;
+	typedef std::vector<unsigned char> byte_vector_type;
+
+	/**
+	* \brief A chunk is hot (vRaw holds it), being compressed (vRaw and fCompressing), cold (vCompressed holds it),
+	* or spilled (uSpillBytes of compressed data at uSpillOffset in the spill file).
+	* fCompressing is declared last so that it is destroyed, and waited for, before vRaw.
+	*/
+	struct Chunk
+	{
+		chunk_vector_type vRaw;
+		byte_vector_type vCompressed;
+		std::uint64_t uSpillOffset = 0;
+		size_type uSpillBytes = 0;
+		bool bSpilled = false;
+		std::future<byte_vector_type> fCompressing;
+	};
+
+	/**
+	* \brief Bytes of a chunk held in memory
+	*/
+	static size_type chunk_bytes(const Chunk& chunk) noexcept
+	{
+		return chunk.vRaw.capacity() * sizeof(element_type) + chunk.vCompressed.capacity();
+	}
+
+	/**
+	* \brief Writes the oldest compressed chunks to the spill file until the memory budget is met
+	* Chunks before m_uSpillCursor are already spilled, so each chunk is looked at once.
+	*/
+	void spill()
+	{
+		if (!m_pSpill)
+		{
+			return;
+		}
+		while (m_uResidentBytes > m_uMemoryBudget && m_uSpillCursor < m_chunks.size())
+		{
+			Chunk& chunk = m_chunks[m_uSpillCursor];
+			if (!chunk.vRaw.empty())
+			{
+				//the rest of the chunks are hot
+				break;
+			}
+			if (!chunk.bSpilled)
+			{
+				chunk.uSpillOffset = m_pSpill->append(chunk.vCompressed.data(), chunk.vCompressed.size());
+				chunk.uSpillBytes = chunk.vCompressed.size();
+				chunk.bSpilled = true;
+				m_uResidentBytes -= chunk_bytes(chunk);
+				byte_vector_type().swap(chunk.vCompressed);
+			}
+			++m_uSpillCursor;
+		}
+	}
+
+	/**
+	* \brief Reads a spilled chunk's compressed data back into memory
+	* If the chunk is the last one in the file (it is when pop_back reaches it), its space is given back.
+	*/
+	void warm_from_spill(Chunk& chunk)
+	{
+		chunk.vCompressed.resize(chunk.uSpillBytes);
+		m_pSpill->read(chunk.uSpillOffset, chunk.vCompressed.data(), chunk.uSpillBytes);
+		if (chunk.uSpillOffset + chunk.uSpillBytes == m_pSpill->size())
+		{
+			m_pSpill->release_tail(chunk.uSpillOffset);
+		}
+		chunk.bSpilled = false;
+		m_uResidentBytes += chunk_bytes(chunk);
+	}
+
+	/**
+	* \brief Starts compressing a full chunk, unless it is already cold or being compressed (pop_back only warms the last chunk)
+	*/
+	void cool(size_type uChunk)
+	{
+		Chunk& chunk = m_chunks[uChunk];
+		if (chunk.vRaw.empty() || chunk.fCompressing.valid())
+		{
+			return;
+		}
+		const unsigned char* pBytes = reinterpret_cast<const unsigned char*>(chunk.vRaw.data());
+		size_type uBytes = chunk.vRaw.size() * sizeof(element_type);
+		if (m_bBackground)
+		{
+			chunk.fCompressing = std::async(std::launch::async, [pBytes, uBytes]()
+			{
+				byte_vector_type vCompressed;
+				codec_type::compress(pBytes, uBytes, sizeof(element_type), vCompressed);
+				return vCompressed;
+			});
+			m_dPending.push_back(uChunk);
+		}
+		else
+		{
+			m_uResidentBytes -= chunk_bytes(chunk);
+			codec_type::compress(pBytes, uBytes, sizeof(element_type), chunk.vCompressed);
+			chunk.vCompressed.shrink_to_fit();
+			chunk_vector_type().swap(chunk.vRaw);
+			m_uResidentBytes += chunk_bytes(chunk);
+			spill();
+		}
+	}
+
+	/**
+	* \brief Commits finished background compressions, in the order they were started
+	* \param[in] bWait Whether to wait for the ones that are still running
+	*/
+	void collect(bool bWait)
+	{
+		bool bCommitted = false;
+		while (!m_dPending.empty())
+		{
+			Chunk& chunk = m_chunks[m_dPending.front()];
+			if (!bWait && chunk.fCompressing.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			{
+				break;
+			}
+			m_uResidentBytes -= chunk_bytes(chunk);
+			chunk.vCompressed = chunk.fCompressing.get();
+			chunk.vCompressed.shrink_to_fit();
+			chunk_vector_type().swap(chunk.vRaw);
+			m_uResidentBytes += chunk_bytes(chunk);
+			m_dPending.pop_front();
+			bCommitted = true;
+		}
+		if (bCommitted)
+		{
+			spill();
+		}
+	}
+
+	/**
+	* \brief Makes a chunk hot again so that it can be modified
+	*/
+	void warm(size_type uChunk)
+	{
+		Chunk& chunk = m_chunks[uChunk];
+		if (chunk.fCompressing.valid())
+		{
+			//still hot, drop the compressed copy
+			chunk.fCompressing.get();
+			m_dPending.erase(std::find(m_dPending.begin(), m_dPending.end(), uChunk));
+		}
+		if (chunk.vRaw.empty())
+		{
+			if (chunk.bSpilled)
+			{
+				warm_from_spill(chunk);
+				m_uSpillCursor = std::min(m_uSpillCursor, uChunk);
+			}
+			m_uResidentBytes -= chunk_bytes(chunk);
+			chunk.vRaw = chunk_vector_type(chunk_size, element_type(), m_alloc);
+			codec_type::decompress(chunk.vCompressed.data(), chunk.vCompressed.size(), reinterpret_cast<unsigned char*>(chunk.vRaw.data()), chunk_size * sizeof(element_type), sizeof(element_type));
+			byte_vector_type().swap(chunk.vCompressed);
+			m_uResidentBytes += chunk_bytes(chunk);
+			std::lock_guard<std::mutex> lock(*m_pCacheMutex);
+			m_lCache.remove_if([uChunk](const cache_entry_type& entry) { return entry.first == uChunk; });
+		}
+	}
+
+	/**
+	* \brief The decompressed copy of a cold chunk, from the cache or freshly decompressed. The cache mutex must be held.
+	* Once the cache is full, a miss decompresses into the buffer of the least recently used entry instead of allocating one.
+	*/
+	const chunk_vector_type& cached_chunk(size_type uChunk) const
+	{
+		for (typename std::list<cache_entry_type>::iterator it = m_lCache.begin(); it != m_lCache.end(); ++it)
+		{
+			if (it->first == uChunk)
+			{
+				m_lCache.splice(m_lCache.begin(), m_lCache, it);
+				return m_lCache.front().second;
+			}
+		}
+		if (m_lCache.size() < m_uCacheChunks)
+		{
+			m_lCache.emplace_front(no_chunk, chunk_vector_type(chunk_size, element_type(), m_alloc));
+		}
+		else
+		{
+			m_lCache.splice(m_lCache.begin(), m_lCache, std::prev(m_lCache.end()));
+			//a failed decompression must not leave the old contents under the new chunk
+			m_lCache.front().first = no_chunk;
+		}
+		const Chunk& chunk = m_chunks[uChunk];
+		unsigned char* pDst = reinterpret_cast<unsigned char*>(m_lCache.front().second.data());
+		if (chunk.bSpilled)
+		{
+			//fault it in from the spill file
+			m_vSpillBytes.resize(chunk.uSpillBytes);
+			m_pSpill->read(chunk.uSpillOffset, m_vSpillBytes.data(), chunk.uSpillBytes);
+			codec_type::decompress(m_vSpillBytes.data(), chunk.uSpillBytes, pDst, chunk_size * sizeof(element_type), sizeof(element_type));
+		}
+		else
+		{
+			codec_type::decompress(chunk.vCompressed.data(), chunk.vCompressed.size(), pDst, chunk_size * sizeof(element_type), sizeof(element_type));
+		}
+		m_lCache.front().first = uChunk;
+		return m_lCache.front().second;
+	}
+
+	typedef std::pair<size_type, chunk_vector_type> cache_entry_type;
+
+	/**
+	* Marks a cache entry whose buffer holds no chunk
+	*/
+	static const size_type no_chunk = ~size_type(0);
+
+	BinaryVectorList<Chunk> m_chunks;
+	std::deque<size_type> m_dPending;
+	mutable std::list<cache_entry_type> m_lCache;
+	mutable byte_vector_type m_vSpillBytes;
+	size_type m_uSize;
+	size_type m_uHotChunks;
+	size_type m_uCacheChunks;
+	bool m_bBackground;
+	size_type m_uResidentBytes;
+	size_type m_uMemoryBudget;
+	size_type m_uSpillCursor;
+	std::unique_ptr<bvl::detail::SpillFile> m_pSpill;
+	std::unique_ptr<std::mutex> m_pCacheMutex;
+	allocator_type m_alloc;
+};
+
+template<typename element_type, typename codec_type, typename allocator_type>
+const unsigned TieredBinaryVectorList<element_type, codec_type, allocator_type>::chunk_log2;
+
+template<typename element_type, typename codec_type, typename allocator_type>
+const typename TieredBinaryVectorList<element_type, codec_type, allocator_type>::size_type TieredBinaryVectorList<element_type, codec_type, allocator_type>::chunk_size;
+
+template<typename element_type, typename codec_type, typename allocator_type>
+const typename TieredBinaryVectorList<element_type, codec_type, allocator_type>::size_type TieredBinaryVectorList<element_type, codec_type, allocator_type>::no_chunk;
+
+/**
+* \brief Exchange content of TieredBinaryVectorLists
+*/
+template<typename element_type, typename codec_type, typename allocator_type>
+void swap(TieredBinaryVectorList<element_type, codec_type, allocator_type>& bvlLeft, TieredBinaryVectorList<element_type, codec_type, allocator_type>& bvlRight)
+{
+	bvlLeft.swap(bvlRight);
+}
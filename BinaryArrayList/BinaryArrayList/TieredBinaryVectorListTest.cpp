@@ -0,0 +1,309 @@
+/** \file TieredBinaryVectorListTest.cpp
+* \brief Tests of TieredBinaryVectorList: moves, background compression, the spill file and external_sort
+* \author Taylor Dowlen
+* \copyright GNU General Public License v3.0
+* \warning THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "TieredBinaryVectorList.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+	typedef TieredBinaryVectorList<std::uint64_t> tiered_type;
+
+	/**
+	* \brief Element i of every test list. Slowly changing, so the chunks compress.
+	*/
+	std::uint64_t value_at(std::size_t i)
+	{
+		return i / 3;
+	}
+
+	void fill(tiered_type& list, std::size_t uCount)
+	{
+		for (std::size_t i = list.size(); i < uCount; ++i)
+		{
+			list.push_back(value_at(i));
+		}
+	}
+
+	bool holds_values(const tiered_type& list, std::size_t uCount)
+	{
+		if (list.size() != uCount)
+		{
+			return false;
+		}
+		std::vector<std::uint64_t> vRead(tiered_type::chunk_size);
+		for (std::size_t uFirst = 0; uFirst < uCount; uFirst += vRead.size())
+		{
+			std::size_t uTaken = std::min(vRead.size(), uCount - uFirst);
+			list.read(uFirst, uTaken, vRead.data());
+			for (std::size_t i = 0; i < uTaken; ++i)
+			{
+				if (vRead[i] != value_at(uFirst + i))
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	/**
+	* \brief Size of a file on disk, -1 if it cannot be opened
+	*/
+	long file_size(const char* pPath)
+	{
+		std::FILE* pFile = std::fopen(pPath, "rb");
+		if (!pFile)
+		{
+			return -1;
+		}
+		std::fseek(pFile, 0, SEEK_END);
+		long lSize = std::ftell(pFile);
+		std::fclose(pFile);
+		return lSize;
+	}
+
+	void test_move()
+	{
+		const std::size_t uCount = 2000000;
+		tiered_type a;
+		fill(a, uCount);
+
+		tiered_type b(std::move(a));
+		BVL_CHECK(holds_values(b, uCount));
+		//the source is a usable empty list
+		BVL_CHECK(a.empty());
+		BVL_CHECK(a.memory_usage() == 0);
+		a.push_back(0);
+		BVL_CHECK(a.size() == 1 && a[0] == 0);
+		fill(a, tiered_type::chunk_size * 4);
+		BVL_CHECK(holds_values(a, tiered_type::chunk_size * 4));
+
+		//assignment releases what the target held
+		a = std::move(b);
+		BVL_CHECK(holds_values(a, uCount));
+		BVL_CHECK(b.empty());
+		fill(b, 1000);
+		BVL_CHECK(holds_values(b, 1000));
+
+		swap(a, b);
+		BVL_CHECK(holds_values(a, 1000));
+		BVL_CHECK(holds_values(b, uCount));
+	}
+
+	void test_background_compression()
+	{
+		const std::size_t uCount = tiered_type::chunk_size * 20 + 123;
+		tiered_type list(2, 4, true);
+		fill(list, uCount);
+		list.flush();
+		//17 cold chunks of i / 3 compress far below their raw size
+		BVL_CHECK(list.memory_usage() < uCount * sizeof(std::uint64_t) / 2);
+		BVL_CHECK(holds_values(list, uCount));
+
+		std::mt19937_64 rng(7);
+		bool bRandomReads = true;
+		for (int i = 0; i < 10000; ++i)
+		{
+			std::size_t n = static_cast<std::size_t>(rng() % uCount);
+			bRandomReads = bRandomReads && list[n] == value_at(n);
+		}
+		BVL_CHECK(bRandomReads);
+
+		//popping back into a cold chunk warms it, and the list grows again from there
+		std::size_t uShorter = tiered_type::chunk_size * 9 + 5;
+		while (list.size() > uShorter)
+		{
+			list.pop_back();
+		}
+		BVL_CHECK(holds_values(list, uShorter));
+		fill(list, uCount);
+		BVL_CHECK(holds_values(list, uCount));
+
+		//moving while compressions are still running
+		tiered_type moved(std::move(list));
+		fill(moved, uCount + tiered_type::chunk_size * 3);
+		BVL_CHECK(holds_values(moved, uCount + tiered_type::chunk_size * 3));
+	}
+
+	void test_spill()
+	{
+		const std::size_t uChunkBytes = tiered_type::chunk_size * sizeof(std::uint64_t);
+		const std::size_t uBudget = uChunkBytes;
+		const std::size_t uCacheChunks = 2;
+		const std::size_t uCount = tiered_type::chunk_size * 40;
+		tiered_type list(2, uCacheChunks, true);
+		list.set_spill_file("TieredBinaryVectorListTest.spill", uBudget);
+		fill(list, uCount);
+		list.flush();
+		//the hot chunks, the cache and the chunk being filled may exceed the budget, the cold chunks may not
+		BVL_CHECK(list.memory_usage() <= uBudget + (uCacheChunks + 3) * uChunkBytes);
+		BVL_CHECK(holds_values(list, uCount));
+
+		std::mt19937_64 rng(11);
+		bool bRandomReads = true;
+		for (int i = 0; i < 2000; ++i)
+		{
+			std::size_t n = static_cast<std::size_t>(rng() % uCount);
+			bRandomReads = bRandomReads && list[n] == value_at(n);
+		}
+		BVL_CHECK(bRandomReads);
+
+		//popping back into a spilled chunk reads it back from the file
+		std::size_t uShorter = tiered_type::chunk_size * 3 + 17;
+		while (list.size() > uShorter)
+		{
+			list.pop_back();
+		}
+		BVL_CHECK(holds_values(list, uShorter));
+		fill(list, uCount);
+		BVL_CHECK(holds_values(list, uCount));
+
+		tiered_type moved(std::move(list));
+		BVL_CHECK(holds_values(moved, uCount));
+		BVL_CHECK(list.empty());
+
+		moved.clear();
+		fill(moved, uCount / 2);
+		BVL_CHECK(holds_values(moved, uCount / 2));
+	}
+
+	void test_spill_file_change()
+	{
+		const std::size_t uChunkBytes = tiered_type::chunk_size * sizeof(std::uint64_t);
+		const std::size_t uBudget = uChunkBytes;
+		const std::size_t uCount = tiered_type::chunk_size * 40;
+		const char* pFirst = "TieredBinaryVectorListTest.spill";
+		const char* pSecond = "TieredBinaryVectorListTest2.spill";
+		tiered_type list(2, 2, false);
+		list.set_spill_file(pFirst, uBudget);
+		fill(list, uCount);
+		std::size_t uBefore = list.memory_usage();
+
+		//the spilled chunks move to the new file without being read back into memory
+		list.set_spill_file(pSecond, uBudget);
+		BVL_CHECK(list.memory_usage() <= uBefore + uChunkBytes);
+		BVL_CHECK(file_size(pFirst) == -1);
+		BVL_CHECK(holds_values(list, uCount));
+		list.set_spill_file(pSecond, uBudget * 2);
+		BVL_CHECK(holds_values(list, uCount));
+
+		//popping back and growing again reuses the space of the chunks read back (the sizes allow for unflushed writes)
+		long lSpilled = file_size(pSecond);
+		for (int iRound = 0; iRound < 3; ++iRound)
+		{
+			while (list.size() > tiered_type::chunk_size * 5)
+			{
+				list.pop_back();
+			}
+			fill(list, uCount);
+		}
+		BVL_CHECK(file_size(pSecond) < lSpilled + lSpilled / 2);
+		BVL_CHECK(holds_values(list, uCount));
+	}
+
+	bool holds_model(const tiered_type& list, const std::vector<std::uint64_t>& model)
+	{
+		std::vector<std::uint64_t> vRead(list.size());
+		list.read(0, list.size(), vRead.data());
+		return vRead == model;
+	}
+
+	void test_external_sort()
+	{
+		const std::size_t uChunkBytes = tiered_type::chunk_size * sizeof(std::uint64_t);
+		const char* pSpill = "TieredBinaryVectorListTest.spill";
+		std::mt19937_64 rng(29);
+		std::vector<std::uint64_t> model;
+		tiered_type list(2, 2, true);
+		tiered_type unspilled(2, 2, false);
+		list.set_spill_file(pSpill, uChunkBytes);
+		for (std::size_t i = 0; i < tiered_type::chunk_size * 7 + 123; ++i)
+		{
+			model.push_back(rng() % 100000);
+			list.push_back(model.back());
+			unspilled.push_back(model.back());
+		}
+
+		//the same sort makes the same comparisons, so the count of one tells where the merge of the next is
+		std::size_t uCalls = 0;
+		std::size_t uThrowAt = 0;
+		auto counted = [&uCalls, &uThrowAt](std::uint64_t a, std::uint64_t b)
+		{
+			if (++uCalls == uThrowAt)
+			{
+				throw std::runtime_error("comparison");
+			}
+			return a < b;
+		};
+		unspilled.external_sort("", uChunkBytes * 2, counted);
+		std::vector<std::uint64_t> vSorted(model);
+		std::sort(vSorted.begin(), vSorted.end());
+		BVL_CHECK(holds_model(unspilled, vSorted));
+
+		//a comparison that throws late in the merge, after every run is on disk, leaves the list as it was
+		uThrowAt = uCalls - 1000;
+		uCalls = 0;
+		bool bThrew = false;
+		try
+		{
+			list.external_sort("", uChunkBytes * 2, counted);
+		}
+		catch (const std::runtime_error&)
+		{
+			bThrew = true;
+		}
+		BVL_CHECK(bThrew && holds_model(list, model));
+		BVL_CHECK(file_size(pSpill) > 0);
+
+		//a scratch directory that does not exist fails before anything is read
+		bThrew = false;
+		try
+		{
+			list.external_sort("no_such_directory", uChunkBytes * 2);
+		}
+		catch (const std::runtime_error&)
+		{
+			bThrew = true;
+		}
+		BVL_CHECK(bThrew && holds_model(list, model));
+
+		//the sorted list spills to the list's own file again and keeps growing
+		list.external_sort("", uChunkBytes * 2);
+		BVL_CHECK(holds_model(list, vSorted));
+		BVL_CHECK(file_size(pSpill) > 0);
+		list.push_back(7);
+		vSorted.push_back(7);
+		BVL_CHECK(holds_model(list, vSorted));
+
+		//one run, sorted in memory, and a custom comparison
+		list.external_sort("", uChunkBytes * 16, std::greater<std::uint64_t>());
+		std::sort(vSorted.begin(), vSorted.end(), std::greater<std::uint64_t>());
+		BVL_CHECK(holds_model(list, vSorted));
+	}
+}
+
+void bvl::test::run_tiered_tests()
+{
+	test_move();
+	test_background_compression();
+	test_spill();
+	test_spill_file_change();
+	test_external_sort();
+}